@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "dictionary.hpp"
+
+//compares merging dictionaries by addNode with unionWith
+//usage: bench_set_operations [n] [threads], by default n = 10000000 and threads = number of hardware threads
+
+using Clock = std::chrono::steady_clock;
+
+//keys are interleaved, so every part of both trees is merged
+void createDictionary(Dictionary<int,int>& dictionary, int n, int offset)
+{
+    for(int i = 0; i < n; ++i)
+    {
+        dictionary.addNode(2 * i + offset,i);
+    }
+}
+
+double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+    if(n <= 0 || threads < 0)
+    {
+        std::cerr << "n has to be positive and threads can't be negative" << std::endl;
+        return 1;
+    }
+
+    //every element of the second dictionary is added one by one
+    Dictionary<int,int> naive;
+    Dictionary<int,int> other;
+    createDictionary(naive,n,0);
+    createDictionary(other,n,1);
+    Clock::time_point start = Clock::now();
+    for(auto it = other.begin(); it != other.end(); ++it)
+    {
+        naive.addNode(it->first,it->second);
+    }
+    double naiveTime = seconds(start);
+
+    //nodes are moved, trees are split and joined
+    Dictionary<int,int> merged;
+    other.clear();
+    createDictionary(merged,n,0);
+    createDictionary(other,n,1);
+    start = Clock::now();
+    merged.unionWith(other,threads);
+    double unionTime = seconds(start);
+
+    std::cout << "n = " << n << std::endl;
+    std::cout << "addNode loop: " << naiveTime << " s" << std::endl;
+    std::cout << "unionWith: " << unionTime << " s" << std::endl;
+    if(naive.getSize() != merged.getSize() || !merged.isAVL())
+    {
+        std::cerr << "results differ" << std::endl;
+        return 1;
+    }
+    return 0;
+}
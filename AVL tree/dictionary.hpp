@@ -1,30 +1,214 @@
 #ifndef DICTIONARY_HPP
 #define DICTIONARY_HPP
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <queue>
+#include <stdexcept>
 #include <string>
-#include <stack>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+//operator<=> is used only if compiler and standard library support it
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#define DICTIONARY_THREE_WAY_OPERATOR
+#endif
+
+//checks if a.compare(b) can be used, as for std::string and std::string_view
+template <typename A, typename B, typename = void>
+struct HasCompareMethod : std::false_type {};
+template <typename A, typename B>
+struct HasCompareMethod<A,B,std::void_t<decltype(std::declval<const A&>().compare(std::declval<const B&>()))>> : std::true_type {};
+
+//checks if a <=> b can be used, it is always false before C++20
+template <typename A, typename B, typename = void>
+struct HasThreeWayOperator : std::false_type {};
+#ifdef DICTIONARY_THREE_WAY_OPERATOR
+template <typename A, typename B>
+struct HasThreeWayOperator<A,B,std::void_t<decltype(std::declval<const A&>() <=> std::declval<const B&>())>> : std::true_type {};
+#endif
+
+//three-way comparator, dictionary using it compares keys once on every level
+//strings are compared by compare method, types with operator<=> by it, other types by operator< twice
+//it is transparent, so find can take types comparable with Key
+struct ThreeWayCompare
+{
+    using is_transparent = void;
 
-template <typename Key, typename Info>
+    template <typename A, typename B>
+    int operator()(const A& a, const B& b) const
+    {
+        if constexpr(HasCompareMethod<A,B>::value)
+        {
+            int result = a.compare(b);
+            return result < 0 ? -1 : (result > 0 ? 1 : 0);
+        }
+#ifdef DICTIONARY_THREE_WAY_OPERATOR
+        else if constexpr(HasThreeWayOperator<A,B>::value)
+        {
+            auto result = a <=> b;
+            return result < 0 ? -1 : (result > 0 ? 1 : 0);
+        }
+#endif
+        else
+        {
+            return a < b ? -1 : (b < a ? 1 : 0);
+        }
+    };
+};
+
+//augmentations give additional data kept in every node for its whole subtree
+//Field is base of the node, refresh is called for node, whose children changed
+//children are given as nullptr if they don't exist
+struct NoAugmentation
+{
+    template <typename Key, typename Info>
+    struct Field
+    {
+        void refresh(const Key&, const Info&, const Field*, const Field*) {};
+    };
+};
+
+//every node knows number of elements in its subtree
+//dictionary can give rank of the key, element with given index and move iterators by many positions in O(log n)
+struct OrderStatistics
+{
+    template <typename Key, typename Info>
+    struct Field
+    {
+        int subtreeSize = 1;
+
+        void refresh(const Key&, const Info&, const Field* left, const Field* right)
+        {
+            subtreeSize = 1 + (left != nullptr ? left->subtreeSize : 0) + (right != nullptr ? right->subtreeSize : 0);
+        };
+    };
+};
+
+//monoids used by Aggregation
+//every monoid gives type of aggregate, identity element, conversion of single info and associative combine
+template <typename T>
+struct InfoSum
+{
+    using Value = T;
+    static Value identity() {return T();};
+    static Value lift(const T& info) {return info;};
+    static Value combine(const Value& a, const Value& b) {return a + b;};
+};
+
+template <typename T>
+struct InfoCount
+{
+    using Value = long long;
+    static Value identity() {return 0;};
+    static Value lift(const T&) {return 1;};
+    static Value combine(const Value& a, const Value& b) {return a + b;};
+};
+
+template <typename T>
+struct InfoMin
+{
+    using Value = T;
+    static Value identity() {return std::numeric_limits<T>::max();};
+    static Value lift(const T& info) {return info;};
+    static Value combine(const Value& a, const Value& b) {return std::min(a,b);};
+};
+
+template <typename T>
+struct InfoMax
+{
+    using Value = T;
+    static Value identity() {return std::numeric_limits<T>::lowest();};
+    static Value lift(const T& info) {return info;};
+    static Value combine(const Value& a, const Value& b) {return std::max(a,b);};
+};
+
+//every node keeps aggregate of infos from its subtree in order of keys
+//dictionary can aggregate infos of any range of keys in O(log n)
+//info changed through iterator is not aggregated again, it should be changed by upsert or insertOrAssign
+template <typename M>
+struct Aggregation
+{
+    using Monoid = M;
+
+    template <typename Key, typename Info>
+    struct Field
+    {
+        typename Monoid::Value aggregate = Monoid::identity();
+
+        void refresh(const Key&, const Info& info, const Field* left, const Field* right)
+        {
+            aggregate = Monoid::combine(left != nullptr ? left->aggregate : Monoid::identity(),Monoid::lift(info));
+            if(right != nullptr)
+            {
+                aggregate = Monoid::combine(aggregate,right->aggregate);
+            }
+        };
+    };
+};
+
+//checks if nodes with field F know size of their subtree
+template <typename F, typename = void>
+struct HasSubtreeSize : std::false_type {};
+template <typename F>
+struct HasSubtreeSize<F,std::void_t<decltype(std::declval<const F&>().subtreeSize)>> : std::true_type {};
+
+//checks if allocator can place new object after the previously allocated ones, skipping freed memory, like PoolAllocator
+template <typename A, typename = void>
+struct HasFreshAllocation : std::false_type {};
+template <typename A>
+struct HasFreshAllocation<A,std::void_t<decltype(std::declval<A&>().allocateFresh())>> : std::true_type {};
+
+//nodes are allocated by Allocator rebound to the node type
+//PoolAllocator from pool_allocator.hpp keeps them in slabs and reuses deleted ones
+//keys are ordered by Compare, it can be less than comparator or three-way comparator like ThreeWayCompare
+//Augmentation adds data to every node, e.g. OrderStatistics, NoAugmentation costs no memory
+template <typename Key, typename Info, typename Compare = std::less<Key>, typename Allocator = std::allocator<std::pair<const Key,Info>>,
+          typename Augmentation = NoAugmentation>
 class Dictionary 
 {
 private:
+    using Field = typename Augmentation::template Field<Key,Info>;
+    //empty field is not stored and never refreshed
+    static constexpr bool augmented = !std::is_empty<Field>::value;
+    static constexpr bool counted = HasSubtreeSize<Field>::value;
+
     //element on which dictionary operates
-    struct Node
+    //height is not stored, balance factor is enough to keep tree balanced
+    struct Node : Field
     {
         Key key;
         Info info;
 
-        Node* parent;
+        //nodes are aligned at least to 4 bytes, so two lowest bits of the parent pointer are always 0
+        //they keep balance factor(height of right subtree - height of left subtree) increased by 1
+        std::uintptr_t parentAndBalance;
         Node* right;
         Node* left;
-        
-        //balance factor
-        int bfactor;
-        //height of the tree or subtree with this node as a root
-        int height;
-        Node(Key k,Info i,Node* p = nullptr, Node* r = nullptr, Node* l = nullptr,int bf = 0, int h = 1)
-        : key(k), info(i), parent(p), right(r),left(l),bfactor(bf), height(h) {};
+
+        template <typename K, typename I>
+        Node(K&& k,I&& i,Node* p = nullptr, Node* r = nullptr, Node* l = nullptr,int bf = 0)
+        : key(std::forward<K>(k)), info(std::forward<I>(i)), parentAndBalance(reinterpret_cast<std::uintptr_t>(p) | static_cast<std::uintptr_t>(bf + 1)), right(r),left(l) {};
+
+        //info is constructed in place from given arguments, node is not linked yet
+        template <typename K, typename... Args>
+        Node(std::piecewise_construct_t,K&& k,Args&&... args)
+        : key(std::forward<K>(k)), info(std::forward<Args>(args)...), parentAndBalance(1), right(nullptr), left(nullptr) {};
+
+        Node* getParent() const {return reinterpret_cast<Node*>(parentAndBalance & ~static_cast<std::uintptr_t>(3));};
+        void setParent(Node* p) {parentAndBalance = reinterpret_cast<std::uintptr_t>(p) | (parentAndBalance & 3);};
+        //balance factor is always -1, 0 or 1
+        int getBalance() const {return static_cast<int>(parentAndBalance & 3) - 1;};
+        void setBalance(int bf) {parentAndBalance = (parentAndBalance & ~static_cast<std::uintptr_t>(3)) | static_cast<std::uintptr_t>(bf + 1);};
     };
+    static_assert(alignof(Node) >= 4, "Balance factor is stored in two lowest bits of node's address.");
 public:
     class Iterator
     {
@@ -32,7 +216,7 @@ public:
         Node* curr;
         //holds dictionary to which iterator belongs
         //protects from using iterator in improper dictionary
-        const Dictionary<Key,Info>* dictionary;
+        const Dictionary<Key,Info,Compare,Allocator,Augmentation>* dictionary;
 
         //this pair will be returned by operator->
         std::pair<const Key&,Info&>* pair;
@@ -42,7 +226,7 @@ public:
         //private contructor
         //makes things faster in some functions
         //user can't know about curr and dictionary
-        Iterator(Node* node, const Dictionary<Key,Info>* dic) : curr(node), dictionary(dic), pair(nullptr){};
+        Iterator(Node* node, const Dictionary<Key,Info,Compare,Allocator,Augmentation>* dic) : curr(node), dictionary(dic), pair(nullptr){};
 
         //checks if iterator can move in given direction
         //if not throws an exception
@@ -82,6 +266,13 @@ public:
         Iterator& operator--();
         Iterator operator--(int);
 
+        //moves iterator by many elements at once, only with OrderStatistics, O(log n)
+        //end iterator can be reached, but not passed
+        Iterator& operator+=(int);
+        Iterator& operator-=(int);
+        Iterator operator+(int) const;
+        Iterator operator-(int) const;
+
         Iterator() : curr(nullptr), dictionary(nullptr), pair(nullptr){};
         Iterator(const Iterator& it) : Iterator() {*this = it;};
         ~Iterator() {delete pair;};
@@ -91,7 +282,7 @@ public:
         //that's why it there is no left child we can't do goLeft/getLeft etc.
         bool isRightPossible() const {return ( curr != nullptr && curr->right != nullptr); };
         bool isLeftPossible() const {return (curr != nullptr && curr->left != nullptr);};
-        bool isParentPossible() const {return (curr != nullptr && curr->parent != nullptr);};
+        bool isParentPossible() const {return (curr != nullptr && curr->getParent() != nullptr);};
         
         bool isEmpty()const {return dictionary == nullptr;};
         bool isEnd()const {return curr == nullptr;};
@@ -105,74 +296,353 @@ public:
         friend class Dictionary;
     };
 
+    //elements with keys from [lo, hi) returned by range
+    //bounds are found once, then elements are visited by Iterator::operator++
+    //view is invalidated as iterators are, by deleting its bounds
+    class Range
+    {
+    private:
+        Iterator first;
+        Iterator afterLast;
+
+        Range(const Iterator& f, const Iterator& a) : first(f), afterLast(a){};
+    public:
+        Iterator begin() const {return first;};
+        Iterator end() const {return afterLast;};
+        bool isEmpty() const {return first == afterLast;};
+
+        friend class Dictionary;
+    };
+
+    //order of nodes in memory after compact
+    enum class Layout{IN_ORDER,BFS};
+
+    //work done by rebalancing since creation of dictionary or the last reset
+    struct RebalanceStats
+    {
+        //double rotation is counted as two rotations
+        long long rotations = 0;
+        //retraces started by adding and deleting
+        long long retraces = 0;
+        //nodes, whose balance factor was checked during retraces
+        long long retracedNodes = 0;
+        //the longest path walked by one retrace
+        int maxRetraceDepth = 0;
+    };
+
 private:
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    NodeAllocator nodeAllocator;
+    Compare compare;
     Node* root;
     //number of elements in the dictionary
     int size;
+    //the smallest and the highest element, nullptr if dictionary is empty
+    //rotations keep order of nodes, so only adding and deleting can change them
+    Node* leftmost;
+    Node* rightmost;
+    RebalanceStats stats;
+
+    //every node is created and destroyed by these functions
+    template <typename... Args>
+    Node* createNode(Args&&...);
+    //node is placed after the previously created ones, if allocator can do it, otherwise it is the same as createNode
+    template <typename... Args>
+    Node* createFreshNode(Args&&...);
+    //constructs node in given memory, memory is freed if constructor throws
+    template <typename... Args>
+    Node* constructNode(Node* memory, Args&&...);
+    void destroyNode(Node*);
+
+    //finds leftmost and rightmost again, used when one of them was deleted
+    void updateExtremes();
+
+    //comparator returning int(negative, 0 or positive) compares keys once on every level
+    //comparator returning bool is treated as less than
+    static constexpr bool ordering = !std::is_same<typename std::decay<decltype(std::declval<const Compare&>()
+                                     (std::declval<const Key&>(),std::declval<const Key&>()))>::type,bool>::value;
+    //std::less of keys with operator<=> gives the same order, so searching uses ThreeWayCompare instead of it
+    //pointers are left to std::less, only it gives total order of them
+    static constexpr bool defaultLess = (std::is_same<Compare,std::less<Key>>::value || std::is_same<Compare,std::less<>>::value) &&
+                                        HasThreeWayOperator<Key,Key>::value && !std::is_pointer<Key>::value;
+    static constexpr bool threeWay = ordering || defaultLess;
+    template <typename A, typename B>
+    bool lessThan(const A& a, const B& b) const
+    {
+        if constexpr(ordering)
+        {
+            return compare(a,b) < 0;
+        }
+        else
+        {
+            return compare(a,b);
+        }
+    };
+    //used only if threeWay is true
+    template <typename A, typename B>
+    int compareKeys(const A& a, const B& b) const
+    {
+        if constexpr(defaultLess)
+        {
+            return ThreeWayCompare()(a,b);
+        }
+        else
+        {
+            return compare(a,b);
+        }
+    };
 
-    //change of height or bfactor of some node may cause also change of its parent height etc.
-    //this function updates given element and every parent up to root
-    //rotates element if it is needed
-    void updateNodesAndRotate(Iterator);
-    //update given element's height and bfactor
-    void updateNode(Iterator);
+    //returns node with given key
+    //if there is no such a node, returns nullptr and place, where node with this key should be linked
+    template <typename K>
+    Node* findPlace(const K&, Node*& parent, bool& leftChild) const;
+    template <typename K>
+    Iterator findKey(const K&) const;
+    //the first node with key not smaller than k(or greater than k if strict), nullptr if there is no such a node
+    Node* lowerNode(const Key& k, bool strict) const;
+    //links new node in place found by findPlace and rebalances the tree
+    void linkNode(Node* toAdd, Node* parent, bool leftChild);
+    //common part of both tryEmplace functions
+    template <typename K, typename... Args>
+    std::pair<Iterator,bool> emplaceKey(K&& k, Args&&... args);
+
+    //copies every node of other dictionary together with its balance factor
+    //tree is walked by parent pointers, so no additional memory is needed
+    void cloneTree(const Dictionary<Key,Info,Compare,Allocator,Augmentation>&);
+
+    //deletes every node of the subtree in postorder, parent of the subtree loses this child
+    //returns number of deleted nodes
+    int deleteSubtree(Node*);
+
+    //recalculate augmented data of the node from its children
+    void refresh(Node*);
+    //refreshes node and every node above it
+    void refreshPath(Node*);
+    //refreshes every node of the subtree from the bottom
+    void refreshSubtree(Node*);
+    static int subtreeSize(const Node* node) {return node != nullptr ? node->subtreeSize : 0;};
+    //position of node in order, size for nullptr
+    int indexOf(const Node*) const;
+
+    //builds perfectly balanced tree from next count elements of sorted range
+    //the middle element becomes a root, so heights of subtrees differ at most by 1
+    //returns root of the tree, it is moved after the last used element, height is set to height of the tree
+    //fresh nodes are created by createFreshNode
+    template <typename ForwardIt>
+    Node* buildBalanced(ForwardIt& it, long long count, int& height, bool fresh = false);
+    //builds the same tree as buildBalanced, but nodes are created level by level
+    //elements are moved from the vector
+    Node* buildBalancedBreadthFirst(std::vector<std::pair<Key,Info>>&, bool fresh = false);
+
+    //left or right subtree of parent grew(change = 1) or shrank(change = -1) by one level
+    //balance factors of parents are updated as long as height of their subtree changes
+    //rotations are done where they are needed
+    //returns change of height of the whole tree
+    int retrace(Node* parent, bool leftChild, int change);
+    //rotates node with balance factor 2 or -2, node can't store such a value, so it is given
+    //returns change of subtree's height caused by rotation: 0 or -1
+    int rebalance(Node*, int balance);
 
     //rotations used to mantain dictionary as AVL tree
-    void rotateLeft(Iterator);
-    void rotateRight(Iterator);
-    //also double right rotation
-    void rotateLeftRight(Iterator);
-    //also double left rotation
-    void rotateRightLeft(Iterator);
-
-    //elements from the bottom of the tree are on the top of the stack
-    //used in functions where processing starts from the bottom of the tree
-    std::stack<Iterator> createStack();
+    //they only relink nodes and refresh augmented data, balance factors are set by rebalance
+    void rotateLeft(Node*);
+    void rotateRight(Node*);
+
+    //functions below work on detached trees, their roots have no parent
+    //heights are not stored, they are given and calculated from balance factors on the way down
+    //root of this dictionary is used as a place for the tree being changed, because rotations may change its top
+    //so this should be empty dictionary or dictionary, whose tree was taken out
+
+    //tree of the whole dictionary becomes given tree with count elements
+    void takeTree(Node* tree, int count);
+    static int heightOf(const Node*);
+    //takes children away from the node and gives their heights
+    static void detachChildren(Node* node, int height, Node*& left, int& leftHeight, Node*& right, int& rightHeight);
+    //tree made of left tree, middle node and right tree, every key of left is smaller than middle and every key of right greater
+    //middle is put at the side of the higher tree, where its height is the same as the other tree, then retrace is done
+    //O(difference of heights + 1), height is set to height of the result
+    Node* joinTrees(Node* left, int leftHeight, Node* middle, Node* right, int rightHeight, int& height);
+    //join without middle node, the smallest node of right is taken as middle
+    Node* joinTrees(Node* left, int leftHeight, Node* right, int rightHeight, int& height);
+    //divides tree into trees with keys smaller and greater than k, O(log n)
+    //returns detached node with key k, nullptr if there is no such a node
+    Node* splitTree(Node* tree, int height, const Key& k, Node*& smaller, int& smallerHeight, Node*& greater, int& greaterHeight);
+
+    //set operations split the first tree by root of the second one and do the same for both halves
+    //halves are disjoint, so they can be done by different threads, threads is number of threads, which can be used
+    //nodes, which have to be destroyed, are put to garbage and destroyed at the end by one thread
+    Node* uniteTrees(Node* a, int aHeight, Node* b, int bHeight, int& height, std::vector<Node*>& garbage, int threads);
+    Node* intersectTrees(Node* a, int aHeight, const Node* b, int& height, std::vector<Node*>& garbage, int threads);
+    Node* subtractTrees(Node* a, int aHeight, const Node* b, int& height, std::vector<Node*>& garbage, int threads);
+    //runs both tasks, the first one in new thread if there are free threads and trees are high enough
+    //task of other thread gets its own empty dictionary to work on and its own garbage, its statistics are added afterwards
+    static constexpr int parallelHeight = 16;
+    template <typename Task1, typename Task2>
+    void runBoth(int threads, int height, std::vector<Node*>& garbage, Task1 first, Task2 second);
+    //destroys garbage of set operation and gives new size of the dictionary
+    void finishSetOperation(Node* tree, int previousSize, int added, std::vector<Node*>& garbage);
+    //nodes are moved between dictionaries, so they have to be freed by equal allocators
+    void checkAllocators(const Dictionary<Key,Info,Compare,Allocator,Augmentation>&) const;
+    void addStats(const RebalanceStats&);
+
+    //checks subtree and returns its height
+    //ok is set to false if subtree is not AVL tree or its balance factors are wrong
+    int checkSubtree(const Node*, bool& ok) const;
 
 public:
-    Dictionary() : root(nullptr), size(0){};
-    Dictionary(const Dictionary<Key,Info>& toCopy) : Dictionary() {copy(toCopy);};
+    Dictionary() : Dictionary(Compare(),Allocator()){};
+    explicit Dictionary(const Compare& comparator, const Allocator& allocator = Allocator()) : nodeAllocator(allocator), compare(comparator),
+    root(nullptr), size(0), leftmost(nullptr), rightmost(nullptr){};
+    explicit Dictionary(const Allocator& allocator) : Dictionary(Compare(),allocator){};
+    //dictionary built by buildFromSorted
+    template <typename ForwardIt>
+    Dictionary(ForwardIt first, ForwardIt last, bool sortInput = false, const Compare& comparator = Compare(), const Allocator& allocator = Allocator())
+    : Dictionary(comparator,allocator) {buildFromSorted(first,last,sortInput);};
+    Dictionary(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& toCopy) : nodeAllocator(NodeTraits::select_on_container_copy_construction(toCopy.nodeAllocator)),
+    compare(toCopy.compare), root(nullptr), size(0), leftmost(nullptr), rightmost(nullptr) {copy(toCopy);};
     ~Dictionary() {clear();};
 
+    Allocator getAllocator() const {return Allocator(nodeAllocator);};
+
     //add node
     //return true if succeed
     //false if there is an element with such a key
-    bool addNode(Key,Info);
+    bool addNode(const Key&,const Info&);
+
+    //functions below find place of the key once and do everything during this descent
+    //if there is no element with such a key, info is constructed in place from args
+    //otherwise nothing changes and args are not used
+    //return iterator to the element with the key and true if it was added
+    template <typename... Args>
+    std::pair<Iterator,bool> tryEmplace(const Key& k, Args&&... args) {return emplaceKey(k,std::forward<Args>(args)...);};
+    template <typename... Args>
+    std::pair<Iterator,bool> tryEmplace(Key&& k, Args&&... args) {return emplaceKey(std::move(k),std::forward<Args>(args)...);};
+    //adds element or replaces info of existing one
+    template <typename I>
+    std::pair<Iterator,bool> insertOrAssign(const Key& k, I&& i);
+    //calls update(info) for element with given key
+    //if there is no such an element, it is added with Info() before update
+    //e.g. upsert(word, [](int& count){++count;}) counts words
+    template <typename Function>
+    Iterator upsert(const Key& k, Function update);
 
     //delete node
     //true if succeed
     //false if there is no element with such a key
-    bool deleteNode(Key);
+    bool deleteNode(const Key&);
     bool deleteNode(Iterator);
 
     //return iterator to the element with given key
     //return end iterator if there is no element with such a key
-    Iterator find(Key)const;
+    Iterator find(const Key& k) const {return findKey(k);};
+    //if Compare is transparent(e.g. std::less<>), key can be given as other type comparable with Key
+    //e.g. std::string_view for std::string keys, without creating Key
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Iterator find(const K& k) const {return findKey(k);};
+
+    //functions below descend once, return end iterator if there is no such an element
+    //the first element with key not smaller than k
+    Iterator lowerBound(const Key& k) const {return Iterator(lowerNode(k,false),this);};
+    //the first element with key greater than k
+    Iterator upperBound(const Key& k) const {return Iterator(lowerNode(k,true),this);};
+    //the greatest element with key not greater than k
+    Iterator floor(const Key& k) const;
+    //the smallest element with key not smaller than k, the same as lowerBound
+    Iterator ceiling(const Key& k) const {return lowerBound(k);};
+    //pair(lowerBound(k), upperBound(k)), keys are unique, so there is at most one element between them
+    //upper bound is the next element after lower one, so there is only one descent
+    std::pair<Iterator,Iterator> equalRange(const Key& k) const;
+    //elements with keys not smaller than lo and smaller than hi, in order
+    //e.g. for(auto& element : dictionary.range(lo, hi)), range is empty if hi is not greater than lo
+    Range range(const Key& lo, const Key& hi) const;
+
+    //functions below need OrderStatistics augmentation, they are O(log n)
+    //number of elements with keys smaller than k, k doesn't need to be in the dictionary
+    int rank(const Key& k) const;
+    //iterator to the element with given index in order(from 0), end iterator for index equal to size
+    //throws std::invalid_argument for other indexes
+    Iterator select(int index) const;
+
+    //functions below need Aggregation augmentation
+    //aggregate of infos of every element in order of keys, O(1)
+    template <typename A = Augmentation>
+    typename A::Monoid::Value aggregate() const;
+    //aggregate of infos of elements with keys not smaller than lo and smaller than hi, O(log n)
+    //identity is returned if there is no such an element
+    template <typename A = Augmentation>
+    typename A::Monoid::Value aggregate(const Key& lo, const Key& hi) const;
 
     //iterator to the root
     Iterator top() const;
     //iterator to the smallest element
     Iterator begin() const;
+    //iterator to the highest element, end iterator if dictionary is empty
+    Iterator last() const;
     //end iterator
     Iterator end() const;
 
     void clear();
-    
-    int getSize()const {return size;};
-    int getHeight() {return root == nullptr ? 0 : root->height;};
 
-    //check if dictionary is AVL tree
+    //replaces elements with pairs(key, info) from range [first, last) in O(n)
+    //keys have to be sorted in increasing order without repetitions, otherwise std::invalid_argument is thrown
+    //if sortInput is true, range is sorted first and only the first element with every key is taken, as addNode does
+    template <typename ForwardIt>
+    void buildFromSorted(ForwardIt first, ForwardIt last, bool sortInput = false);
+
+    //after many adds and deletes nodes are scattered in memory
+    //compact copies every element into new node, nodes are created in given order
+    //with PoolAllocator new nodes are taken one after another from free space of slabs, freed nodes are not reused
+    //tree becomes perfectly balanced, iterators are invalidated
+    //old nodes are freed only when the new tree is built, so if it fails, dictionary is not changed
+    void compact(Layout layout = Layout::IN_ORDER);
+    
+    int getSize()const;
+    //height is found by going down through the higher subtree, O(log n)
+    int getHeight() const;
+
+    const RebalanceStats& getRebalanceStats() const {return stats;};
+    void resetRebalanceStats() {stats = RebalanceStats();};
+
+    //functions below move nodes between dictionaries, so their allocators have to be equal
+    //otherwise std::invalid_argument is thrown
+    //elements with keys not smaller than k are moved to greater, the rest stays in this dictionary, O(log n)
+    //greater is cleared first, it needs OrderStatistics, sizes of both parts are taken from their roots
+    void split(const Key& k, Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater);
+    //element(k, i) and every element of greater are added to this dictionary, greater is left empty, O(log n)
+    //every key of this dictionary has to be smaller than k and every key of greater has to be greater than k
+    void join(const Key& k, const Info& i, Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater);
+    //the same without middle element
+    void join(Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater);
+
+    //set operations take O(m log(n/m + 1)) time, where m is size of the smaller dictionary
+    //parts of the trees are done in parallel by up to threads threads, 0 means number of hardware threads
+    //Compare can't throw during them
+    //every element of other, whose key is not in this dictionary, is moved here, other is left empty
+    //for equal keys info from this dictionary is kept, as addNode does
+    void unionWith(Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads = 0);
+    //elements, whose keys are not in other, are deleted, other is not changed
+    void intersect(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads = 0);
+    //elements, whose keys are in other, are deleted, other is not changed
+    void difference(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads = 0);
+
+    //check if dictionary is AVL tree, with OrderStatistics sizes of subtrees are also checked
     //created especially for testing
     bool isAVL();
 
-    void copy(const Dictionary<Key,Info>&);
-    Dictionary<Key,Info>& operator=(const Dictionary<Key,Info>&);
+    void copy(const Dictionary<Key,Info,Compare,Allocator,Augmentation>&);
+    Dictionary<Key,Info,Compare,Allocator,Augmentation>& operator=(const Dictionary<Key,Info,Compare,Allocator,Augmentation>&);
 };
 
+//dictionary, which takes memory from std::pmr::memory_resource
+template <typename Key, typename Info>
+using PmrDictionary = Dictionary<Key,Info,std::less<Key>,std::pmr::polymorphic_allocator<std::pair<const Key,Info>>>;
+
 
 //----------------------------------------------------ITERATOR-----------------------------------------------------
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::Iterator::isValidToAcces()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::isValidToAcces()const
 {
     if(isEnd())
     {
@@ -185,8 +655,8 @@ void Dictionary<Key,Info>::Iterator::isValidToAcces()const
     }
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::Iterator::isValidToMove(Move direction)const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::isValidToMove(Move direction)const
 {
     if(isEmpty())
     {
@@ -224,15 +694,16 @@ void Dictionary<Key,Info>::Iterator::isValidToMove(Move direction)const
     //BACKWARD
     else
     {
-        if(*this == this->dictionary->begin())
+        //begin is cached, so this check is O(1)
+        if(curr == dictionary->leftmost)
         {
             throw std::logic_error("Begin iterator can't be decremented.");
         }
     }
 }       
 
-template <typename Key, typename Info>
-std::pair<const Key&,Info&>& Dictionary<Key,Info>::Iterator::operator*()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+std::pair<const Key&,Info&>& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator*()
 {
     isValidToAcces();
     //pair is not updated if iterator moves
@@ -241,32 +712,32 @@ std::pair<const Key&,Info&>& Dictionary<Key,Info>::Iterator::operator*()
     return *pair;
 }
 
-template <typename Key, typename Info>
-const std::pair<const Key&,Info&>& Dictionary<Key,Info>::Iterator::operator*()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+const std::pair<const Key&,Info&>& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator*()const
 {
     isValidToAcces();
     updatePair();
     return *pair;
 }
 
-template <typename Key, typename Info>
-std::pair<const Key&,Info&>* Dictionary<Key,Info>::Iterator::operator->()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+std::pair<const Key&,Info&>* Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator->()
 {
     isValidToAcces();
     updatePair();
     return pair;
 }
 
-template <typename Key, typename Info>
-const std::pair<const Key&,Info&>* Dictionary<Key,Info>::Iterator::operator->()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+const std::pair<const Key&,Info&>* Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator->()const
 {
     isValidToAcces();
     updatePair();
     return pair;
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::Iterator::updatePair()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::updatePair()
 {
     if(pair == nullptr)
     {
@@ -281,8 +752,8 @@ void Dictionary<Key,Info>::Iterator::updatePair()
     }
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::goRight()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::goRight()
 {
     isValidToMove(Move::RIGHT);
 
@@ -290,8 +761,8 @@ typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::goRight
     return *this;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getRight()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::getRight()const
 {
     isValidToMove(Move::RIGHT);
 
@@ -300,8 +771,8 @@ typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getRight
     return result;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::goLeft()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::goLeft()
 {
     isValidToMove(Move::LEFT);
 
@@ -309,8 +780,8 @@ typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::goLeft(
     return *this;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getLeft()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::getLeft()const
 {
     isValidToMove(Move::LEFT);
 
@@ -319,17 +790,17 @@ typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getLeft(
     return result;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::goParent()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::goParent()
 {
    isValidToMove(Move::PARENT);
 
-    curr = curr->parent;
+    curr = curr->getParent();
     return *this;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getParent()const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::getParent()const
 {
     isValidToMove(Move::PARENT);
 
@@ -338,133 +809,166 @@ typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::getParen
     return result;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::operator++()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator++()
 {
     isValidToMove(Move::FORWARD);
     
     //higher element is in right subtree
-    if(isRightPossible())
+    if(curr->right != nullptr)
     {
-        Iterator it = *this;
-        it.goRight();
+        curr = curr->right;
         //smallest element in this subtree is higher than current key
-        while(it.isLeftPossible())
+        while(curr->left != nullptr)
         {
-            it.goLeft();
+            curr = curr->left;
         }
-
-        *this = it;
     }
     //higher node is somewhere above
+    //it is the first parent, which has previous node in its left subtree
+    //keys are not compared, only shape of the tree is used
     else
     {
-        Iterator it = *this;
-        while(true)
+        Node* previous = curr;
+        curr = curr->getParent();
+        while(curr != nullptr && curr->right == previous)
         {
-            //looking for parent with higher key
-            if(it.isParentPossible())
-            {
-                it.goParent();
-
-                //found higher element
-                if(it->first > this->curr->key)
-                {   
-                  *this = it;
-                  break;
-                }
-            }
-            else
-            {
-                //there is no parent with higher key and there is no node on the right
-                //it is the highest element in the tree
-                //iterator becomes end iterator
-                curr = nullptr;
-                break;
-            }
-        }   
+            previous = curr;
+            curr = curr->getParent();
+        }
+        //if there is no such a parent, it was the highest element in the tree
+        //iterator becomes end iterator(curr == nullptr)
     }
 
     return *this;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::operator++(int)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator++(int)
 {
     Iterator temp = *this;
     ++(*this);
     return temp;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::operator--()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator--()
 {
     //check if not begin
     isValidToMove(Move::BACKWARD);
 
     //end iterator, so we need to move to the highest element
-    if(*this == this->dictionary->end())
+    if(isEnd())
     {
-        Iterator it = this->dictionary->top();
-        while(it.isRightPossible())
-        {
-            it.goRight();
-        }
-        *this = it;
+        curr = dictionary->rightmost;
     }
     //smaller element is somewhere in the left subtree
-    else if(isLeftPossible())
+    else if(curr->left != nullptr)
     {
-        Iterator it = *this;
-        it.goLeft();
+        curr = curr->left;
         //highest element in left subtree is smaller than current key
-        while(it.isRightPossible())
+        while(curr->right != nullptr)
         {
-            it.goRight();
+            curr = curr->right;
         }
-        *this = it;
     }
     else
     {
-        Iterator it = *this;
-        //It is different case than operator++ and checking(isParentPossible) is not required
+        //It is different case than operator++ and checking for nullptr is not required
         //If isValidToMove did not fail it means that iterator is not begin(smaller element exist)
-        //If there is no left node, one of the parent need to be smaller
-        while(true)
+        //If there is no left node, one of the parents need to be smaller
+        Node* previous = curr;
+        curr = curr->getParent();
+        while(curr->left == previous)
         {
-            it.goParent();
-            if(it->first < this->curr->key)
-            {
-                *this = it;
-                 break;
-            }
+            previous = curr;
+            curr = curr->getParent();
         }
     }
     return *this;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::Iterator::operator--(int)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator--(int)
 {
     Iterator temp = *this;
     --(*this);
     return temp;
 }
 
-template <typename Key, typename Info>
-bool Dictionary<Key,Info>::Iterator::operator!=(const Iterator& it) const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator+=(int times)
+{
+    static_assert(counted, "Iterator can jump only in dictionary with OrderStatistics.");
+    if(times < 0)
+    {
+        return *this -= -times;
+    }
+    if(times > 0)
+    {
+        isValidToMove(Move::FORWARD);
+        //position is found going up and new element going down from the root
+        int index = dictionary->indexOf(curr);
+        if(times > dictionary->size - index)
+        {
+            throw std::logic_error("End iterator can't be incremented.");
+        }
+        curr = dictionary->select(index + times).curr;
+    }
+    return *this;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator-=(int times)
+{
+    static_assert(counted, "Iterator can jump only in dictionary with OrderStatistics.");
+    if(times < 0)
+    {
+        return *this += -times;
+    }
+    if(times > 0)
+    {
+        isValidToMove(Move::BACKWARD);
+        int index = dictionary->indexOf(curr);
+        if(times > index)
+        {
+            throw std::logic_error("Begin iterator can't be decremented.");
+        }
+        curr = dictionary->select(index - times).curr;
+    }
+    return *this;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator+(int times) const
+{
+    Iterator result = *this;
+    result += times;
+    return result;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator-(int times) const
+{
+    Iterator result = *this;
+    result -= times;
+    return result;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator!=(const Iterator& it) const
 {
     return !(*this == it);
 }
 
-template <typename Key, typename Info>
-bool Dictionary<Key,Info>::Iterator::operator==(const Iterator& it) const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator==(const Iterator& it) const
 {
     return (curr == it.curr && dictionary == it.dictionary);
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::operator=(const Iterator& it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator& Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator::operator=(const Iterator& it)
 {
     curr = it.curr;
     dictionary = it.dictionary;
@@ -472,16 +976,26 @@ typename Dictionary<Key,Info>::Iterator& Dictionary<Key,Info>::Iterator::operato
 }
 
 //--------------------------------------------DICTIONARY------------------------------------------
-template <typename Key, typename Info>
-Dictionary<Key,Info>& Dictionary<Key,Info>::operator=(const Dictionary<Key,Info>& toCopy)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+Dictionary<Key,Info,Compare,Allocator,Augmentation>& Dictionary<Key,Info,Compare,Allocator,Augmentation>::operator=(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& toCopy)
 {
+    //self-copy check inside copy function
+    if constexpr(NodeTraits::propagate_on_container_copy_assignment::value)
+    {
+        if(nodeAllocator != toCopy.nodeAllocator)
+        {
+            //nodes have to be freed by allocator, which created them
+            clear();
+            nodeAllocator = toCopy.nodeAllocator;
+        }
+    }
     copy(toCopy);
 
     return *this;
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::copy(const Dictionary<Key,Info>& toCopy)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::copy(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& toCopy)
 {
     //self copy
     if(this == &toCopy)
@@ -490,6 +1004,7 @@ void Dictionary<Key,Info>::copy(const Dictionary<Key,Info>& toCopy)
     }
 
     clear();
+    compare = toCopy.compare;
 
     //nothing to copy
     if(toCopy.getSize() == 0)
@@ -497,117 +1012,230 @@ void Dictionary<Key,Info>::copy(const Dictionary<Key,Info>& toCopy)
         return;
     }
 
-    //if we add level by level tree will be all the time balanced
-    //there will not be any rotations
+    //nodes are copied with the same shape, so there are no comparisons and rotations
     //dictionaries will be equal
-
-    std::queue<Iterator> queue;
-    queue.push(toCopy.top());
-
-    while(queue.size() > 0)
+    try
+    {
+        cloneTree(toCopy);
+    }
+    catch(...)
     {
-        Iterator it = queue.front();
-        queue.pop();
+        clear();
+        throw;
+    }
+}
 
-        addNode(it->first,it->second);
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::cloneTree(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& toCopy)
+{
+    const Node* source = toCopy.root;
+    root = createNode(source->key,source->info,nullptr,nullptr,nullptr,source->getBalance());
+    //augmented data is copied as balance factor, shape of the tree is the same
+    static_cast<Field&>(*root) = *source;
+    Node* copied = root;
+    ++size;
+
+    //preorder walk, both trees are walked at the same time
+    //child, which is not copied yet, is visited first
+    //if both children are copied, we go back to the parent
+    while(source != nullptr)
+    {
+        if(source == toCopy.leftmost)
+        {
+            leftmost = copied;
+        }
+        if(source == toCopy.rightmost)
+        {
+            rightmost = copied;
+        }
 
-        if(it.isRightPossible())
+        if(source->left != nullptr && copied->left == nullptr)
         {
-            queue.push(it.getRight());
+            source = source->left;
+            copied->left = createNode(source->key,source->info,copied,nullptr,nullptr,source->getBalance());
+            copied = copied->left;
+            static_cast<Field&>(*copied) = *source;
+            ++size;
         }
-        
-        if(it.isLeftPossible())
+        else if(source->right != nullptr && copied->right == nullptr)
         {
-            queue.push(it.getLeft());
+            source = source->right;
+            copied->right = createNode(source->key,source->info,copied,nullptr,nullptr,source->getBalance());
+            copied = copied->right;
+            static_cast<Field&>(*copied) = *source;
+            ++size;
+        }
+        else
+        {
+            source = source->getParent();
+            copied = copied->getParent();
         }
     }
 }
 
-template <typename Key, typename Info>
-bool Dictionary<Key,Info>::addNode(Key k, Info i)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename K>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::findPlace(const K& k, Node*& parent, bool& leftChild) const
 {
-    if(size == 0)
+    parent = nullptr;
+    leftChild = false;
+    Node* node = root;
+
+    if constexpr(threeWay)
     {
-        Node* toAdd = new Node(k,i);
-        root = toAdd;
-        ++size;
+        //one comparison on every level
+        while(node != nullptr)
+        {
+            auto result = compareKeys(k,node->key);
+            if(result == 0)
+            {
+                return node;
+            }
+            parent = node;
+            leftChild = result < 0;
+            node = leftChild ? node->left : node->right;
+        }
+        return nullptr;
     }
     else
     {
-        //find place for node
-        Iterator it = top();
-        while(true)
+        //less than comparator would need two comparisons to find equal key
+        //instead of it the last node with key not higher than k is remembered
+        //and compared again once the bottom of the tree is reached
+        Node* candidate = nullptr;
+        while(node != nullptr)
         {
-            //go right
-            if(k > it->first)
-            {
-                if(it.isRightPossible())
-                {
-                    it.goRight();
-                }
-                //there is no option to go right -> we found a proper place
-                else
-                {
-                    Node* toAdd = new Node(k,i, it.curr);
-                    it.curr->right = toAdd;
-                    ++size;
-
-                    //there is no element on the left and element is instered to the right
-                    //as a result of that the height of parent changed
-                    //we need to update bfactor and height of every parent and did rotations if necessary
-                    if(!it.isLeftPossible())
-                    {
-                        updateNodesAndRotate(it);
-                    }
-                    //if there is element on the left and element on the right is inserted
-                    //the height of the parent did not change, neither did height of other parents
-                    //bfactor only changed from -1 to 0
-                    else
-                    {
-                        it.curr->bfactor = 0;
-                    }
-                    break;
-                }
-            }
-            else if(k < it->first)
+            parent = node;
+            leftChild = compare(k,node->key);
+            if(leftChild)
             {
-                if(it.isLeftPossible())
-                {
-                    it.goLeft();
-                }
-                //there is no option to go left -> we found proper place
-                else
-                {
-                    Node* toAdd = new Node(k,i,it.curr);
-                    it.curr->left = toAdd;
-                    ++size;
-
-                    if(!it.isRightPossible())
-                    {
-                        updateNodesAndRotate(it);
-                    }
-                    else
-                    {
-                        it.curr->bfactor = 0;
-                    }
-                    break;
-                }
-                
+                node = node->left;
             }
-            //k == curr->first
             else
             {
-                //element already exist in the tree
-                return false;
+                candidate = node;
+                node = node->right;
             }
         }
+        if(candidate != nullptr && !compare(candidate->key,k))
+        {
+            return candidate;
+        }
+        return nullptr;
+    }
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::linkNode(Node* toAdd, Node* parent, bool leftChild)
+{
+    ++size;
+    toAdd->setParent(parent);
+    refresh(toAdd);
+    if(parent == nullptr)
+    {
+        root = toAdd;
+        leftmost = rightmost = toAdd;
+        return;
+    }
+
+    if(leftChild)
+    {
+        parent->left = toAdd;
+        //only left child of the smallest element can be smaller
+        if(parent == leftmost)
+        {
+            leftmost = toAdd;
+        }
+    }
+    else
+    {
+        parent->right = toAdd;
+        if(parent == rightmost)
+        {
+            rightmost = toAdd;
+        }
+    }
+
+    //subtree of the parent grew
+    //if parent had the other child, height of the parent did not change and retrace stops at once
+    //otherwise balance factors of parents are updated and rotations are done if necessary
+    retrace(parent,leftChild,1);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::addNode(const Key& k, const Info& i)
+{
+    //find place for node
+    Node* parent;
+    bool leftChild;
+    if(findPlace(k,parent,leftChild) != nullptr)
+    {
+        //element already exist in the tree
+        return false;
     }
 
+    linkNode(createNode(k,i),parent,leftChild);
     return true;
 }
 
-template <typename Key, typename Info>
-bool Dictionary<Key,Info>::deleteNode(Key k)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename K, typename... Args>
+std::pair<typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator,bool> Dictionary<Key,Info,Compare,Allocator,Augmentation>::emplaceKey(K&& k, Args&&... args)
+{
+    Node* parent;
+    bool leftChild;
+    Node* found = findPlace(k,parent,leftChild);
+    if(found != nullptr)
+    {
+        return std::make_pair(Iterator(found,this),false);
+    }
+
+    Node* toAdd = createNode(std::piecewise_construct,std::forward<K>(k),std::forward<Args>(args)...);
+    linkNode(toAdd,parent,leftChild);
+    return std::make_pair(Iterator(toAdd,this),true);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename I>
+std::pair<typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator,bool> Dictionary<Key,Info,Compare,Allocator,Augmentation>::insertOrAssign(const Key& k, I&& i)
+{
+    Node* parent;
+    bool leftChild;
+    Node* found = findPlace(k,parent,leftChild);
+    if(found != nullptr)
+    {
+        found->info = std::forward<I>(i);
+        refreshPath(found);
+        return std::make_pair(Iterator(found,this),false);
+    }
+
+    Node* toAdd = createNode(k,std::forward<I>(i));
+    linkNode(toAdd,parent,leftChild);
+    return std::make_pair(Iterator(toAdd,this),true);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename Function>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::upsert(const Key& k, Function update)
+{
+    Node* parent;
+    bool leftChild;
+    Node* found = findPlace(k,parent,leftChild);
+    if(found == nullptr)
+    {
+        found = createNode(std::piecewise_construct,k);
+        linkNode(found,parent,leftChild);
+    }
+
+    //info is changed in place, key stays the same, so the tree does not change
+    //only aggregates above the node need to be updated
+    update(found->info);
+    refreshPath(found);
+    return Iterator(found,this);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::deleteNode(const Key& k)
 {
     Iterator it = find(k);
     //if element wasn't found
@@ -619,8 +1247,8 @@ bool Dictionary<Key,Info>::deleteNode(Key k)
     return deleteNode(it);
 }
 
-template <typename Key, typename Info>
-bool Dictionary<Key,Info>::deleteNode(Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::deleteNode(Iterator it)
 {
     if(it.dictionary != this)
     {
@@ -632,28 +1260,37 @@ bool Dictionary<Key,Info>::deleteNode(Iterator it)
         throw std::invalid_argument("End iterator can't be used.");
     }
 
+    //checks if node, which is really deleted, is the smallest or the highest one
+    //data of other nodes can be moved, but nodes stay in the same order
+    bool extremeRemoved;
+
     if(it.isLeaf())
     {
         if(it.curr != root)
         {
             //break connection from parent to the deleted node
-            if(it.curr->parent->left == it.curr)
+            Node* parent = it.curr->getParent();
+            bool leftChild = parent->left == it.curr;
+            if(leftChild)
             {
-                it.curr->parent->left = nullptr;
+                parent->left = nullptr;
             }
             else
             {
-                it.curr->parent->right = nullptr;
+                parent->right = nullptr;
             }
-            //height of the parent did change
+            //one subtree of the parent shrank
             //we need to update parents on the higher level
-            updateNodesAndRotate(Iterator(it.curr->parent,this));
-            delete it.curr;
+            extremeRemoved = it.curr == leftmost || it.curr == rightmost;
+            retrace(parent,leftChild,-1);
+            destroyNode(it.curr);
         }
         //leaf is root -> 1 element in the dictionary
         else
         {
-            delete root;
+            extremeRemoved = true;
+            destroyNode(root);
+            root = nullptr;
         }
         
     }
@@ -671,32 +1308,31 @@ bool Dictionary<Key,Info>::deleteNode(Iterator it)
         it.curr->key = toSwap.curr->key;
         it.curr->info = toSwap.curr->info;
 
+        Node* parent = toSwap.curr->getParent();
         //toSwap is the first on the left from iterator it
-        if(toSwap.curr->parent == it.curr)
+        bool leftChild = parent == it.curr;
+        if(leftChild)
         {
             //breaking connection between parent and toSwap
             //parent takes child of toSwap
-            it.curr->left = toSwap.curr->left;
-            if(it.curr->left != nullptr)
-            {
-                it.curr->left->parent = it.curr;
-            }
+            parent->left = toSwap.curr->left;
         }
         //toSwap is depper than on the left from iterator it
         else
         {
             //breaking connection between parent and toSwap
-            toSwap.curr->parent->right = toSwap.curr->left;
-            if(toSwap.curr->left != nullptr)
-            {
-                toSwap.curr->left->parent = toSwap.curr->parent;
-            }
+            parent->right = toSwap.curr->left;
+        }
+        if(toSwap.curr->left != nullptr)
+        {
+            toSwap.curr->left->setParent(parent);
         }
         
-        //height of the parent of toSwap might have changed
+        //subtree of the parent of toSwap shrank
         //some rotation might be needed also
-        updateNodesAndRotate(Iterator(toSwap.curr->parent,this));
-        delete toSwap.curr;
+        extremeRemoved = toSwap.curr == leftmost || toSwap.curr == rightmost;
+        retrace(parent,leftChild,-1);
+        destroyNode(toSwap.curr);
     }
     else if(it.curr->left == nullptr)
     {
@@ -710,9 +1346,10 @@ bool Dictionary<Key,Info>::deleteNode(Iterator it)
         Node* temp = it.curr->right;
         it.curr->right = nullptr;
 
-        delete temp;
-        //height of iterator it changed
-        updateNodesAndRotate(it);
+        extremeRemoved = temp == leftmost || temp == rightmost;
+        destroyNode(temp);
+        //right subtree of iterator it shrank
+        retrace(it.curr,false,-1);
     }
     //right == nullptr
     else
@@ -724,165 +1361,769 @@ bool Dictionary<Key,Info>::deleteNode(Iterator it)
         Node* temp = it.curr->left;
         it.curr->left = nullptr;
 
-        delete temp;
-        //height of iterator it changed
-        updateNodesAndRotate(it);
+        extremeRemoved = temp == leftmost || temp == rightmost;
+        destroyNode(temp);
+        //left subtree of iterator it shrank
+        retrace(it.curr,true,-1);
     }
 
     --size;
-    if(size == 0)
+
+    if(extremeRemoved)
     {
-        root = nullptr;
+        updateExtremes();
     }
 
     return true;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::find(Key k)const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::lowerNode(const Key& k, bool strict) const
 {
-    if(size == 0)
+    //the last node, where we went left, is the smallest one on the right of k
+    Node* result = nullptr;
+    Node* node = root;
+    while(node != nullptr)
     {
-        return end();
+        bool goLeft = strict ? lessThan(k,node->key) : !lessThan(node->key,k);
+        if(goLeft)
+        {
+            result = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
+        }
     }
+    return result;
+}
 
-    Iterator it = this->top();
-    while(it->first != k)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::floor(const Key& k) const
+{
+    //mirror of lowerNode, the last node, where we went right
+    Node* result = nullptr;
+    Node* node = root;
+    while(node != nullptr)
     {
-        if(k > it->first)
+        if(lessThan(k,node->key))
         {
-            if(it.isRightPossible())
-            {
-                it.goRight();
-            }
-            //if we can't go right there is no such an element in a dictionary
-            else
-            {
-                return this->end();
-            }
-        }else if(k < it->first)
+            node = node->left;
+        }
+        else
         {
-            if(it.isLeftPossible())
+            result = node;
+            node = node->right;
+        }
+    }
+    return Iterator(result,this);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Range Dictionary<Key,Info,Compare,Allocator,Augmentation>::range(const Key& lo, const Key& hi) const
+{
+    Iterator afterLast = lowerBound(hi);
+    if(!lessThan(lo,hi))
+    {
+        return Range(afterLast,afterLast);
+    }
+    return Range(lowerBound(lo),afterLast);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+std::pair<typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator,typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator>
+Dictionary<Key,Info,Compare,Allocator,Augmentation>::equalRange(const Key& k) const
+{
+    Iterator first = lowerBound(k);
+    Iterator afterLast = first;
+    if(first != end() && !lessThan(k,first->first))
+    {
+        ++afterLast;
+    }
+    return std::make_pair(first,afterLast);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename K>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::findKey(const K& k) const
+{
+    Node* parent;
+    bool leftChild;
+    //if there is no such a key, node is nullptr, so end iterator is returned
+    return Iterator(findPlace(k,parent,leftChild),this);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename A>
+typename A::Monoid::Value Dictionary<Key,Info,Compare,Allocator,Augmentation>::aggregate() const
+{
+    using Monoid = typename A::Monoid;
+    return root != nullptr ? root->aggregate : Monoid::identity();
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename A>
+typename A::Monoid::Value Dictionary<Key,Info,Compare,Allocator,Augmentation>::aggregate(const Key& lo, const Key& hi) const
+{
+    using Monoid = typename A::Monoid;
+    using Value = typename Monoid::Value;
+    if(!lessThan(lo,hi))
+    {
+        return Monoid::identity();
+    }
+
+    //the highest node inside the range, paths to both bounds split there
+    Node* split = root;
+    while(split != nullptr)
+    {
+        if(lessThan(split->key,lo))
+        {
+            split = split->right;
+        }
+        else if(!lessThan(split->key,hi))
+        {
+            split = split->left;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if(split == nullptr)
+    {
+        return Monoid::identity();
+    }
+
+    //going to lo, node inside the range is taken together with its right subtree
+    //nodes found deeper are smaller, so they are put before the result
+    Value leftPart = Monoid::identity();
+    for(Node* node = split->left; node != nullptr;)
+    {
+        if(lessThan(node->key,lo))
+        {
+            node = node->right;
+        }
+        else
+        {
+            Value part = Monoid::lift(node->info);
+            if(node->right != nullptr)
             {
-                it.goLeft();
+                part = Monoid::combine(part,node->right->aggregate);
             }
-            //if we can't go element there is no such a key inside a dictionary
-            else
+            leftPart = Monoid::combine(part,leftPart);
+            node = node->left;
+        }
+    }
+
+    //mirror for hi, left subtree is taken and nodes found deeper are greater
+    Value rightPart = Monoid::identity();
+    for(Node* node = split->right; node != nullptr;)
+    {
+        if(!lessThan(node->key,hi))
+        {
+            node = node->left;
+        }
+        else
+        {
+            Value part = Monoid::lift(node->info);
+            if(node->left != nullptr)
             {
-                return this->end();
+                part = Monoid::combine(node->left->aggregate,part);
             }
-            
+            rightPart = Monoid::combine(rightPart,part);
+            node = node->right;
         }
     }
 
-    return it;
+    return Monoid::combine(Monoid::combine(leftPart,Monoid::lift(split->info)),rightPart);
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::top() const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::top() const
 {
     return Iterator(root,this);
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::begin() const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::begin() const
 {
-    Iterator it = top();
     //begin is the smallest element in the tree - the leftmost element
-    while(it.isLeftPossible())
+    return Iterator(leftmost,this);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::last() const
+{
+    return Iterator(rightmost,this);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::updateExtremes()
+{
+    leftmost = rightmost = root;
+    if(root == nullptr)
     {
-        it.goLeft();
+        return;
+    }
+    while(leftmost->left != nullptr)
+    {
+        leftmost = leftmost->left;
+    }
+    while(rightmost->right != nullptr)
+    {
+        rightmost = rightmost->right;
     }
-
-    return it;
 }
 
-template <typename Key, typename Info>
-typename Dictionary<Key,Info>::Iterator Dictionary<Key,Info>::end() const
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::end() const
 {
     return Iterator(nullptr,this);
 }
 
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::updateNodesAndRotate(Dictionary<Key,Info>::Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::retrace(Node* node, bool leftChild, int change)
 {
-    while(true)
+    //after adding, subtree of node grows if its balance factor stops being 0
+    //after deleting, subtree of node shrinks if its balance factor becomes 0
+    //once height of some subtree does not change, nodes above it stay the same
+    ++stats.retraces;
+    int depth = 0;
+    //rotations refresh nodes, which they move, every node above the change needs refreshing too
+    Node* changed = node;
+    while(node != nullptr && change != 0)
     {
-        updateNode(it);
+        ++depth;
+        int balance = node->getBalance() + (leftChild ? -change : change);
 
-        //check if rotation is needed
-        if(it.curr->bfactor == -2)
+        //rotation changes parent of node, so place of node is remembered before
+        Node* parent = node->getParent();
+        bool nodeIsLeft = parent != nullptr && parent->left == node;
+
+        if(balance == 2 || balance == -2)
+        {
+            //after adding the subtree grew, rotation makes it as high as before adding
+            //after deleting it was as high as before deleting, rotation may make it lower
+            int rotationChange = rebalance(node,balance);
+            change = change > 0 ? change + rotationChange : rotationChange;
+        }
+        else
         {
-            if(it.curr->left->bfactor == -1)
+            node->setBalance(balance);
+            if(change > 0)
             {
-                rotateRight(it);
+                change = balance != 0 ? 1 : 0;
             }
             else
-            //it.curr->left->height == 1
             {
-                rotateLeftRight(it);
+                change = balance == 0 ? -1 : 0;
             }
         }
-        else if(it.curr->bfactor == 2)
+
+        node = parent;
+        leftChild = nodeIsLeft;
+    }
+
+    stats.retracedNodes += depth;
+    stats.maxRetraceDepth = std::max(stats.maxRetraceDepth,depth);
+    refreshPath(changed);
+    //change is not 0 only if retrace went above the root
+    return change;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::rebalance(Node* n1, int balance)
+{
+    //right subtree is too high
+    if(balance == 2)
+    {
+        Node* n2 = n1->right;
+        int n2Balance = n2->getBalance();
+        //single left rotation
+        if(n2Balance >= 0)
         {
-            if(it.curr->right->bfactor == 1)
-            {
-                rotateLeft(it);
-            }
-            else
-            //it.curr->right->bfactor == -1
+            rotateLeft(n1);
+            //n2 was balanced only during deleting, then height does not change
+            n1->setBalance(n2Balance == 0 ? 1 : 0);
+            n2->setBalance(n2Balance == 0 ? -1 : 0);
+            return n2Balance == 0 ? 0 : -1;
+        }
+
+        //double left rotation, left child of n2 becomes a root of the subtree
+        Node* n3 = n2->left;
+        int n3Balance = n3->getBalance();
+        rotateRight(n2);
+        rotateLeft(n1);
+        n1->setBalance(n3Balance == 1 ? -1 : 0);
+        n2->setBalance(n3Balance == -1 ? 1 : 0);
+        n3->setBalance(0);
+        return -1;
+    }
+
+    //left subtree is too high, mirror of the case above
+    Node* n2 = n1->left;
+    int n2Balance = n2->getBalance();
+    //single right rotation
+    if(n2Balance <= 0)
+    {
+        rotateRight(n1);
+        n1->setBalance(n2Balance == 0 ? -1 : 0);
+        n2->setBalance(n2Balance == 0 ? 1 : 0);
+        return n2Balance == 0 ? 0 : -1;
+    }
+
+    //double right rotation
+    Node* n3 = n2->right;
+    int n3Balance = n3->getBalance();
+    rotateLeft(n2);
+    rotateRight(n1);
+    n1->setBalance(n3Balance == -1 ? 1 : 0);
+    n2->setBalance(n3Balance == 1 ? -1 : 0);
+    n3->setBalance(0);
+    return -1;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::getHeight() const
+{
+    return heightOf(root);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::heightOf(const Node* node)
+{
+    //higher subtree is pointed by balance factor
+    int height = 0;
+    for(; node != nullptr; ++height)
+    {
+        node = node->getBalance() < 0 ? node->left : node->right;
+    }
+    return height;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::getSize() const
+{
+    return size;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::clear()
+{
+    //nodes are deleted from the bottom, without deleteNode and its rotations
+    deleteSubtree(root);
+
+    root = nullptr;
+    leftmost = rightmost = nullptr;
+    size = 0;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::deleteSubtree(Node* subtree)
+{
+    if(subtree == nullptr)
+    {
+        return 0;
+    }
+
+    //parent pointers lead back up, so no additional memory is needed
+    Node* above = subtree->getParent();
+    Node* node = subtree;
+    int deleted = 0;
+    while(node != above)
+    {
+        if(node->left != nullptr)
+        {
+            node = node->left;
+        }
+        else if(node->right != nullptr)
+        {
+            node = node->right;
+        }
+        //leaf is deleted and parent forgets about it
+        else
+        {
+            Node* parent = node->getParent();
+            if(parent != nullptr)
             {
-                rotateRightLeft(it);
+                if(parent->left == node)
+                {
+                    parent->left = nullptr;
+                }
+                else
+                {
+                    parent->right = nullptr;
+                }
             }
+            destroyNode(node);
+            ++deleted;
+            node = parent;
+        }
+    }
+    return deleted;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::refresh(Node* node)
+{
+    if constexpr(augmented)
+    {
+        node->refresh(node->key,node->info,node->left,node->right);
+    }
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::refreshPath(Node* node)
+{
+    if constexpr(augmented)
+    {
+        for(; node != nullptr; node = node->getParent())
+        {
+            refresh(node);
         }
+    }
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::refreshSubtree(Node* node)
+{
+    if constexpr(augmented)
+    {
+        //tree is balanced, so recursion is not deeper than height of the tree
+        if(node != nullptr)
+        {
+            refreshSubtree(node->left);
+            refreshSubtree(node->right);
+            refresh(node);
+        }
+    }
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::indexOf(const Node* node) const
+{
+    if(node == nullptr)
+    {
+        return size;
+    }
+
+    //elements on the left of the node and left subtrees of ancestors, which have node on the right
+    int index = subtreeSize(node->left);
+    for(const Node* parent = node->getParent(); parent != nullptr; node = parent, parent = parent->getParent())
+    {
+        if(parent->right == node)
+        {
+            index += subtreeSize(parent->left) + 1;
+        }
+    }
+    return index;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::rank(const Key& k) const
+{
+    static_assert(counted, "Rank can be found only in dictionary with OrderStatistics.");
+    int result = 0;
+    Node* node = root;
+    while(node != nullptr)
+    {
+        if(lessThan(node->key,k))
+        {
+            //node and its left subtree are smaller
+            result += subtreeSize(node->left) + 1;
+            node = node->right;
+        }
+        else
+        {
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Iterator Dictionary<Key,Info,Compare,Allocator,Augmentation>::select(int index) const
+{
+    static_assert(counted, "Element can be selected only in dictionary with OrderStatistics.");
+    if(index < 0 || index > size)
+    {
+        throw std::invalid_argument("Index is out of range.");
+    }
 
-        //if node's height changes parent's height may also change
-        //if height of parent changes the height of parent of parent may change etc.
-        //so we need to check every parent up to root
-        if(!it.isParentPossible())
+    Node* node = root;
+    while(node != nullptr)
+    {
+        int leftSize = subtreeSize(node->left);
+        if(index == leftSize)
         {
             break;
         }
-        it.goParent();
+        if(index < leftSize)
+        {
+            node = node->left;
+        }
+        else
+        {
+            index -= leftSize + 1;
+            node = node->right;
+        }
     }
+    //index equal to size goes through the rightmost node to nullptr
+    return Iterator(node,this);
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::updateNode(Dictionary<Key,Info>::Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename... Args>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::createNode(Args&&... args)
 {
-    int left = it.isLeftPossible() ? it.curr->left->height : 0;
-    int right = it.isRightPossible() ? it.curr->right->height : 0;
+    return constructNode(NodeTraits::allocate(nodeAllocator,1),std::forward<Args>(args)...);
+}
 
-    it.curr->height = std::max(left,right) + 1;
-    it.curr->bfactor = right - left;
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename... Args>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::createFreshNode(Args&&... args)
+{
+    if constexpr(HasFreshAllocation<NodeAllocator>::value)
+    {
+        return constructNode(nodeAllocator.allocateFresh(),std::forward<Args>(args)...);
+    }
+    else
+    {
+        return createNode(std::forward<Args>(args)...);
+    }
 }
 
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename... Args>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::constructNode(Node* memory, Args&&... args)
+{
+    try
+    {
+        NodeTraits::construct(nodeAllocator,memory,std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        NodeTraits::deallocate(nodeAllocator,memory,1);
+        throw;
+    }
+    return memory;
+}
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::clear()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::destroyNode(Node* node)
 {
-    //the fastest way to delete nodes will be from the bottom
-    //it will avoid unecessery rotations done in deleteNode
+    NodeTraits::destroy(nodeAllocator,node);
+    NodeTraits::deallocate(nodeAllocator,node,1);
+}
 
-    if(size > 0)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename ForwardIt>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::buildFromSorted(ForwardIt first, ForwardIt last, bool sortInput)
+{
+    if(sortInput)
     {
-       std::stack<Iterator> stack = createStack();
+        //stable sort keeps the first element with every key before the other ones
+        std::vector<std::pair<Key,Info>> sorted;
+        for(ForwardIt it = first; it != last; ++it)
+        {
+            sorted.emplace_back(it->first,it->second);
+        }
+        std::stable_sort(sorted.begin(),sorted.end(),
+                         [this](const std::pair<Key,Info>& a, const std::pair<Key,Info>& b){return lessThan(a.first,b.first);});
+        auto unique = std::unique(sorted.begin(),sorted.end(),
+                                  [this](const std::pair<Key,Info>& a, const std::pair<Key,Info>& b){return !lessThan(a.first,b.first);});
+        sorted.erase(unique,sorted.end());
+        //vector isn't needed anymore, so elements are moved into nodes
+        buildFromSorted(std::make_move_iterator(sorted.begin()),std::make_move_iterator(sorted.end()));
+        return;
+    }
 
-        Iterator it;
-        while(stack.size() > 0)
+    //range is checked before anything is changed
+    //(*it) only names the element, so elements of move iterator are not moved here
+    long long count = 0;
+    for(ForwardIt it = first; it != last; ++it)
+    {
+        ForwardIt next = it;
+        ++next;
+        if(next != last && !lessThan((*it).first,(*next).first))
         {
-            it = stack.top();
-            stack.pop();
-            deleteNode(it);
+            throw std::invalid_argument("Keys have to be sorted and unique.");
         }
+        ++count;
     }
 
+    clear();
+    ForwardIt it = first;
+    int height;
+    root = buildBalanced(it,count,height);
+    size = static_cast<int>(count);
+    updateExtremes();
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::rotateRight(Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename ForwardIt>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::buildBalanced(ForwardIt& it, long long count, int& height, bool fresh)
+{
+    if(count == 0)
+    {
+        height = 0;
+        return nullptr;
+    }
+
+    //elements are taken in order, so the left subtree is built first
+    long long leftCount = (count - 1) / 2;
+    int leftHeight;
+    int rightHeight;
+    Node* left = buildBalanced(it,leftCount,leftHeight,fresh);
+
+    Node* node;
+    try
+    {
+        //(*it) is used instead of it->, so elements of move iterator are moved
+        node = fresh ? createFreshNode((*it).first,(*it).second,nullptr,nullptr,left) : createNode((*it).first,(*it).second,nullptr,nullptr,left);
+    }
+    catch(...)
+    {
+        deleteSubtree(left);
+        throw;
+    }
+    ++it;
+    if(left != nullptr)
+    {
+        left->setParent(node);
+    }
+
+    try
+    {
+        node->right = buildBalanced(it,count - 1 - leftCount,rightHeight,fresh);
+    }
+    catch(...)
+    {
+        deleteSubtree(node);
+        throw;
+    }
+    if(node->right != nullptr)
+    {
+        node->right->setParent(node);
+    }
+
+    height = std::max(leftHeight,rightHeight) + 1;
+    node->setBalance(rightHeight - leftHeight);
+    refresh(node);
+    return node;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::buildBalancedBreadthFirst(std::vector<std::pair<Key,Info>>& elements, bool fresh)
+{
+    //subtree made of count elements starting from first, and place where its root will be linked
+    struct Subtree
+    {
+        long long first;
+        long long count;
+        Node* parent;
+        bool isLeft;
+    };
+    //tree built by buildBalanced has height floor(log2(count)) + 1
+    auto heightOf = [](long long count)
+    {
+        int height = 0;
+        for(; count > 0; count /= 2)
+        {
+            ++height;
+        }
+        return height;
+    };
+
+    Node* result = nullptr;
+    std::queue<Subtree> queue;
+    queue.push({0,static_cast<long long>(elements.size()),nullptr,false});
+    try
+    {
+        while(queue.size() > 0)
+        {
+            Subtree subtree = queue.front();
+            queue.pop();
+            if(subtree.count == 0)
+            {
+                continue;
+            }
+
+            long long leftCount = (subtree.count - 1) / 2;
+            long long rightCount = subtree.count - 1 - leftCount;
+            std::pair<Key,Info>& element = elements[subtree.first + leftCount];
+            int balance = heightOf(rightCount) - heightOf(leftCount);
+            Node* node = fresh ? createFreshNode(std::move(element.first),std::move(element.second),subtree.parent,nullptr,nullptr,balance)
+                               : createNode(std::move(element.first),std::move(element.second),subtree.parent,nullptr,nullptr,balance);
+            if(subtree.parent == nullptr)
+            {
+                result = node;
+            }
+            else if(subtree.isLeft)
+            {
+                subtree.parent->left = node;
+            }
+            else
+            {
+                subtree.parent->right = node;
+            }
+
+            queue.push({subtree.first,leftCount,node,true});
+            queue.push({subtree.first + leftCount + 1,rightCount,node,false});
+        }
+    }
+    catch(...)
+    {
+        deleteSubtree(result);
+        throw;
+    }
+    return result;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::compact(Layout layout)
+{
+    if(root == nullptr)
+    {
+        return;
+    }
+
+    //new tree is built next to the old one, elements are copied, so old tree stays whole until the end
+    //fresh nodes don't go into holes left by deleted nodes, which are scattered among the old ones
+    long long count = getSize();
+    Node* built;
+    if(layout == Layout::IN_ORDER)
+    {
+        //elements are taken straight from the old tree in order
+        Iterator it = begin();
+        int height;
+        built = buildBalanced(it,count,height,true);
+    }
+    else
+    {
+        std::vector<std::pair<Key,Info>> elements;
+        elements.reserve(count);
+        for(Iterator it = begin(); it != end(); ++it)
+        {
+            elements.emplace_back(it->first,it->second);
+        }
+        //children are created after parents, so they are refreshed at the end
+        built = buildBalancedBreadthFirst(elements,true);
+        refreshSubtree(built);
+    }
+
+    deleteSubtree(root);
+    root = built;
+    size = static_cast<int>(count);
+    updateExtremes();
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::rotateRight(Node* n1)
 {  
+    ++stats.rotations;
    
  //         n1           n2
  //        /            /  \       .
@@ -892,54 +2133,51 @@ void Dictionary<Key,Info>::rotateRight(Iterator it)
 
     //three nodes only changes
     //n1, n2 and right child of n2
-    Node* n1 = it.curr;
-    Node* n2 = it.curr->left;
+    Node* n2 = n1->left;
     Node* temp = n2->right;
+    Node* parent = n1->getParent();
 
     //n1 becomes child of n2
-    n2->parent = n1->parent;
-    n1->parent = n2;
+    n2->setParent(parent);
+    n1->setParent(n2);
     n2->right = n1;
    
     //n1 takes right child of n2
     n1->left = temp;
     if(temp != nullptr)
     {
-       temp->parent = n1;
+       temp->setParent(n1);
     }
 
     //create connection from n2's parent to n2
-    if(n2->parent != nullptr)
+    if(parent != nullptr)
     {
-        if(n2->parent->right == n1)
+        if(parent->right == n1)
         {
-            n2->parent->right = n2;
+            parent->right = n2;
         }
         else
         {
-            n2->parent->left = n2;
+            parent->left = n2;
         }
         
     }
-
     //n1 was at a top, it might be a root
     //if yes, we need to change root to n2
-    if(n1 == root)
+    else
     {
         root = n2;
     }
 
-    //n1 and n2 children changes
-    //so their bfactor and height may change
-    //to proper calculate height of n2, we need to know height of its children(n1, n3)
-    //that's why updating starts from n1
-    updateNode(Iterator(n1,this));
-    updateNode(Iterator(n2,this));
+    //n1 is below n2 now
+    refresh(n1);
+    refresh(n2);
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::rotateLeft(Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::rotateLeft(Node* n1)
 {
+    ++stats.rotations;
 //     n1               n2
  //     \              /  \      .
  //     n2      ->    n1   n3
@@ -947,139 +2185,583 @@ void Dictionary<Key,Info>::rotateLeft(Iterator it)
  //       n3
 
     //n1 n2 and left child of n2
-    Node* n1 = it.curr;
-    Node* n2 = it.curr->right;
+    Node* n2 = n1->right;
     Node* temp = n2->left;
+    Node* parent = n1->getParent();
 
     //n1 becomes left child of n2
-    n2->parent = n1->parent;
-    n1->parent = n2;
+    n2->setParent(parent);
+    n1->setParent(n2);
     n2->left = n1;
     
     //n1 takes left child of n2
     n1->right = temp;
     if(temp != nullptr)
     {
-        temp->parent = n1;
+        temp->setParent(n1);
     }
 
     //connection from n2's parent to n2
-    if(n2->parent != nullptr)
+    if(parent != nullptr)
     {
-        if(n2->parent->right == n1)
+        if(parent->right == n1)
         {
-            n2->parent->right = n2;
+            parent->right = n2;
         }
         else
         {
-            n2->parent->left = n2;
+            parent->left = n2;
         }
         
     }
-
     //check if change of root is needed
-    if(n1 == root)
+    else
     {
         root = n2;
     }
 
-    //n1 and n2 children changes -> height of them need to be updated
-    updateNode(Iterator(n1,this));
-    updateNode(Iterator(n2, this));
+    refresh(n1);
+    refresh(n2);
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::rotateRightLeft(Iterator it)
+//--------------------------------------------JOIN AND SPLIT------------------------------------------
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::takeTree(Node* tree, int count)
 {
-    //also known as double left rotation
-    rotateRight(it.getRight());
-    rotateLeft(it);
+    root = tree;
+    if(tree != nullptr)
+    {
+        tree->setParent(nullptr);
+    }
+    size = count;
+    updateExtremes();
 }
 
-template <typename Key, typename Info>
-void Dictionary<Key,Info>::rotateLeftRight(Iterator it)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::detachChildren(Node* node, int height, Node*& left, int& leftHeight, Node*& right, int& rightHeight)
 {
-    //also known as double right rotation
-    rotateLeft(it.getLeft());
-    rotateRight(it);
+    left = node->left;
+    right = node->right;
+    leftHeight = height - (node->getBalance() > 0 ? 2 : 1);
+    rightHeight = height - (node->getBalance() < 0 ? 2 : 1);
+
+    node->left = node->right = nullptr;
+    node->setParent(nullptr);
+    if(left != nullptr)
+    {
+        left->setParent(nullptr);
+    }
+    if(right != nullptr)
+    {
+        right->setParent(nullptr);
+    }
 }
 
-template<typename Key, typename Info>
-bool Dictionary<Key,Info>::isAVL()
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::joinTrees(Node* left, int leftHeight, Node* middle, Node* right, int rightHeight, int& height)
 {
-    if(root == nullptr)
+    //heights differ at most by 1, middle becomes a root
+    if(leftHeight - rightHeight <= 1 && rightHeight - leftHeight <= 1)
     {
-        return true;
+        middle->left = left;
+        middle->right = right;
+        middle->setParent(nullptr);
+        if(left != nullptr)
+        {
+            left->setParent(middle);
+        }
+        if(right != nullptr)
+        {
+            right->setParent(middle);
+        }
+        middle->setBalance(rightHeight - leftHeight);
+        refresh(middle);
+        height = std::max(leftHeight,rightHeight) + 1;
+        return middle;
     }
 
-    std::stack<Iterator> stack = createStack();
-    
-    Iterator it;
+    //going down the right side of left tree or the left side of right tree
+    //until subtree is as high as the lower tree or one level higher
+    bool leftHigher = leftHeight > rightHeight;
+    Node* higher = leftHigher ? left : right;
+    Node* lower = leftHigher ? right : left;
+    int lowerHeight = leftHigher ? rightHeight : leftHeight;
+    Node* parent = nullptr;
+    Node* node = higher;
+    int nodeHeight = leftHigher ? leftHeight : rightHeight;
+    while(nodeHeight > lowerHeight + 1)
+    {
+        parent = node;
+        if(leftHigher)
+        {
+            nodeHeight -= node->getBalance() < 0 ? 2 : 1;
+            node = node->right;
+        }
+        else
+        {
+            nodeHeight -= node->getBalance() > 0 ? 2 : 1;
+            node = node->left;
+        }
+    }
+
+    //middle takes place of the found subtree, which becomes its child together with the lower tree
+    middle->left = leftHigher ? node : lower;
+    middle->right = leftHigher ? lower : node;
+    if(node != nullptr)
+    {
+        node->setParent(middle);
+    }
+    if(lower != nullptr)
+    {
+        lower->setParent(middle);
+    }
+    middle->setBalance(leftHigher ? lowerHeight - nodeHeight : nodeHeight - lowerHeight);
+    middle->setParent(parent);
+    if(leftHigher)
+    {
+        parent->right = middle;
+    }
+    else
+    {
+        parent->left = middle;
+    }
+    refresh(middle);
+
+    //subtree of parent grew by one level, as after adding a node
+    root = higher;
+    height = (leftHigher ? leftHeight : rightHeight) + retrace(parent,!leftHigher,1);
+    Node* result = root;
+    root = nullptr;
+    return result;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::joinTrees(Node* left, int leftHeight, Node* right, int rightHeight, int& height)
+{
+    if(left == nullptr || right == nullptr)
+    {
+        height = left == nullptr ? rightHeight : leftHeight;
+        return left == nullptr ? right : left;
+    }
+
+    Node* first = right;
+    while(first->left != nullptr)
+    {
+        first = first->left;
+    }
+    Node* none;
+    int noneHeight;
+    Node* rest;
+    int restHeight;
+    //the smallest node is the only one, which is not greater
+    Node* middle = splitTree(right,rightHeight,first->key,none,noneHeight,rest,restHeight);
+    return joinTrees(left,leftHeight,middle,rest,restHeight,height);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::splitTree(Node* tree, int height, const Key& k, Node*& smaller, int& smallerHeight, Node*& greater, int& greaterHeight)
+{
+    if(tree == nullptr)
+    {
+        smaller = greater = nullptr;
+        smallerHeight = greaterHeight = 0;
+        return nullptr;
+    }
+
+    //root is taken out and joined again with the part of the tree on its side
+    //heights of joined trees grow on the way up, so all joins cost O(log n) together
+    Node* left;
+    Node* right;
+    int leftHeight;
+    int rightHeight;
+    detachChildren(tree,height,left,leftHeight,right,rightHeight);
+
+    Node* rest;
+    int restHeight;
+    if(lessThan(k,tree->key))
+    {
+        Node* found = splitTree(left,leftHeight,k,smaller,smallerHeight,rest,restHeight);
+        greater = joinTrees(rest,restHeight,tree,right,rightHeight,greaterHeight);
+        return found;
+    }
+    if(lessThan(tree->key,k))
+    {
+        Node* found = splitTree(right,rightHeight,k,rest,restHeight,greater,greaterHeight);
+        smaller = joinTrees(left,leftHeight,tree,rest,restHeight,smallerHeight);
+        return found;
+    }
+
+    smaller = left;
+    smallerHeight = leftHeight;
+    greater = right;
+    greaterHeight = rightHeight;
+    tree->setBalance(0);
+    return tree;
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::checkAllocators(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& other) const
+{
+    if(nodeAllocator != other.nodeAllocator)
+    {
+        throw std::invalid_argument("Nodes can be moved only between dictionaries with equal allocators.");
+    }
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::addStats(const RebalanceStats& other)
+{
+    stats.rotations += other.rotations;
+    stats.retraces += other.retraces;
+    stats.retracedNodes += other.retracedNodes;
+    stats.maxRetraceDepth = std::max(stats.maxRetraceDepth,other.maxRetraceDepth);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::split(const Key& k, Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater)
+{
+    if(&greater == this)
+    {
+        throw std::invalid_argument("Dictionary can't be split into itself.");
+    }
+    static_assert(counted, "Dictionary can be split only with OrderStatistics.");
+    checkAllocators(greater);
+    greater.clear();
+
+    Node* tree = root;
+    int height = getHeight();
+    root = nullptr;
+
+    Node* smaller;
+    Node* bigger;
+    int smallerHeight;
+    int biggerHeight;
+    Node* found = splitTree(tree,height,k,smaller,smallerHeight,bigger,biggerHeight);
+    //element with key k is the smallest one in greater
+    if(found != nullptr)
+    {
+        bigger = joinTrees(nullptr,0,found,bigger,biggerHeight,biggerHeight);
+    }
+
+    takeTree(smaller,subtreeSize(smaller));
+    greater.takeTree(bigger,subtreeSize(bigger));
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::join(const Key& k, const Info& i, Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater)
+{
+    if(&greater == this)
+    {
+        throw std::invalid_argument("Dictionary can't be joined with itself.");
+    }
+    checkAllocators(greater);
+    if((rightmost != nullptr && !lessThan(rightmost->key,k)) || (greater.leftmost != nullptr && !lessThan(k,greater.leftmost->key)))
+    {
+        throw std::invalid_argument("Keys of joined dictionaries have to be in order.");
+    }
+
+    //new node is created before anything is changed
+    Node* middle = createNode(k,i);
+    int count = size + greater.size + 1;
+    Node* left = root;
+    int leftHeight = getHeight();
+    Node* right = greater.root;
+    int rightHeight = greater.getHeight();
+    root = nullptr;
+    greater.root = nullptr;
+    greater.clear();
 
-    int bfactor;
     int height;
+    takeTree(joinTrees(left,leftHeight,middle,right,rightHeight,height),count);
+}
 
-    while(stack.size() > 0)
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::join(Dictionary<Key,Info,Compare,Allocator,Augmentation>& greater)
+{
+    if(&greater == this)
+    {
+        throw std::invalid_argument("Dictionary can't be joined with itself.");
+    }
+    checkAllocators(greater);
+    if(rightmost != nullptr && greater.leftmost != nullptr && !lessThan(rightmost->key,greater.leftmost->key))
     {
-        it = stack.top();
-        stack.pop();
+        throw std::invalid_argument("Keys of joined dictionaries have to be in order.");
+    }
 
-        //saves data currently stored in the tree
-        bfactor = it.curr->bfactor;
-        height = it.curr->height;
+    int count = size + greater.size;
+    Node* left = root;
+    int leftHeight = getHeight();
+    Node* right = greater.root;
+    int rightHeight = greater.getHeight();
+    root = nullptr;
+    greater.root = nullptr;
+    greater.clear();
 
-        //calculates new bfactor and height of node
-        updateNode(it);
+    int height;
+    takeTree(joinTrees(left,leftHeight,right,rightHeight,height),count);
+}
 
-        //if bfactor or height is different after recalculation than before
-        //values in a tree were wrongly calculated during addNode or deleteNode
-        if(it.curr->bfactor != bfactor || it.curr->height != height)
-        {
-            return false;
-        }
+//------------------------------------------SET OPERATIONS------------------------------------------
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+template <typename Task1, typename Task2>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::runBoth(int threads, int height, std::vector<Node*>& garbage, Task1 first, Task2 second)
+{
+    //small trees are not worth creating threads
+    if(threads < 2 || height < parallelHeight)
+    {
+        first(*this,garbage,1);
+        second(*this,garbage,1);
+        return;
+    }
 
-        //absoulute value of bfactor can't be greater than 1
-        //if it is greater, it means that it is not AVL tree
-        if(it.curr->bfactor < -1 || it.curr->bfactor > 1)
+    //nodes are not allocated nor freed, so other thread needs only its own root and statistics
+    Dictionary<Key,Info,Compare,Allocator,Augmentation> work(compare,getAllocator());
+    std::vector<Node*> workGarbage;
+    std::thread worker;
+    try
+    {
+        worker = std::thread([&]() {first(work,workGarbage,threads / 2);});
+    }
+    catch(const std::system_error&)
+    {
+        //no more threads, the first task is done here
+        first(*this,garbage,1);
+    }
+    second(*this,garbage,worker.joinable() ? threads - threads / 2 : 1);
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+
+    garbage.insert(garbage.end(),workGarbage.begin(),workGarbage.end());
+    addStats(work.stats);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::uniteTrees(Node* a, int aHeight, Node* b, int bHeight, int& height, std::vector<Node*>& garbage, int threads)
+{
+    if(a == nullptr || b == nullptr)
+    {
+        height = a == nullptr ? bHeight : aHeight;
+        return a == nullptr ? b : a;
+    }
+
+    //root of a is the middle, b is split by its key
+    Node* aLeft;
+    Node* aRight;
+    int aLeftHeight;
+    int aRightHeight;
+    detachChildren(a,aHeight,aLeft,aLeftHeight,aRight,aRightHeight);
+    Node* bLeft;
+    Node* bRight;
+    int bLeftHeight;
+    int bRightHeight;
+    Node* duplicate = splitTree(b,bHeight,a->key,bLeft,bLeftHeight,bRight,bRightHeight);
+    if(duplicate != nullptr)
+    {
+        garbage.push_back(duplicate);
+    }
+
+    Node* left;
+    Node* right;
+    int leftHeight;
+    int rightHeight;
+    runBoth(threads,std::min(aHeight,bHeight),garbage,
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {left = work.uniteTrees(aLeft,aLeftHeight,bLeft,bLeftHeight,leftHeight,workGarbage,workThreads);},
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {right = work.uniteTrees(aRight,aRightHeight,bRight,bRightHeight,rightHeight,workGarbage,workThreads);});
+    return joinTrees(left,leftHeight,a,right,rightHeight,height);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::intersectTrees(Node* a, int aHeight, const Node* b, int& height, std::vector<Node*>& garbage, int threads)
+{
+    if(a == nullptr || b == nullptr)
+    {
+        //nothing from a is in b
+        if(a != nullptr)
         {
-            return false;
+            garbage.push_back(a);
         }
+        height = 0;
+        return nullptr;
     }
-    return true;
+
+    //a is split by the root of b, which is only read
+    Node* aLeft;
+    Node* aRight;
+    int aLeftHeight;
+    int aRightHeight;
+    Node* found = splitTree(a,aHeight,b->key,aLeft,aLeftHeight,aRight,aRightHeight);
+
+    Node* left;
+    Node* right;
+    int leftHeight;
+    int rightHeight;
+    runBoth(threads,aHeight,garbage,
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {left = work.intersectTrees(aLeft,aLeftHeight,b->left,leftHeight,workGarbage,workThreads);},
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {right = work.intersectTrees(aRight,aRightHeight,b->right,rightHeight,workGarbage,workThreads);});
+    if(found != nullptr)
+    {
+        return joinTrees(left,leftHeight,found,right,rightHeight,height);
+    }
+    return joinTrees(left,leftHeight,right,rightHeight,height);
 }
 
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+typename Dictionary<Key,Info,Compare,Allocator,Augmentation>::Node* Dictionary<Key,Info,Compare,Allocator,Augmentation>::subtractTrees(Node* a, int aHeight, const Node* b, int& height, std::vector<Node*>& garbage, int threads)
+{
+    if(a == nullptr || b == nullptr)
+    {
+        height = aHeight;
+        return a;
+    }
 
-template <typename Key, typename Info>
-std::stack<typename Dictionary<Key,Info>::Iterator> Dictionary<Key,Info>::createStack()
+    Node* aLeft;
+    Node* aRight;
+    int aLeftHeight;
+    int aRightHeight;
+    Node* found = splitTree(a,aHeight,b->key,aLeft,aLeftHeight,aRight,aRightHeight);
+    if(found != nullptr)
+    {
+        garbage.push_back(found);
+    }
+
+    Node* left;
+    Node* right;
+    int leftHeight;
+    int rightHeight;
+    runBoth(threads,aHeight,garbage,
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {left = work.subtractTrees(aLeft,aLeftHeight,b->left,leftHeight,workGarbage,workThreads);},
+            [&](Dictionary<Key,Info,Compare,Allocator,Augmentation>& work, std::vector<Node*>& workGarbage, int workThreads)
+            {right = work.subtractTrees(aRight,aRightHeight,b->right,rightHeight,workGarbage,workThreads);});
+    return joinTrees(left,leftHeight,right,rightHeight,height);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::finishSetOperation(Node* tree, int previousSize, int added, std::vector<Node*>& garbage)
 {
-    //if we proceed through queue, we will acess nodes level by level from top
-    //if add elements of queue to stack
-    //we will be able to acces nodes level by level but from the bottom of the tree
-    std::queue<Iterator> queue;
-    std::stack<Iterator> stack;
-    if(size > 0)
+    int removed = 0;
+    for(Node* node : garbage)
     {
-        queue.push(top());
-        Iterator it;
-        while(queue.size() > 0)
-        {
-            it = queue.front();
-            queue.pop();
-            if(it.isLeftPossible())
-            {
-                queue.push(it.getLeft());
-            }
-            if(it.isRightPossible())
-            {
-                queue.push(it.getRight());
-            }
+        removed += deleteSubtree(node);
+    }
+    takeTree(tree,previousSize + added - removed);
+}
 
-            //every element poped from queue is pushed onto the stack
-            stack.push(it);
-        }
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::unionWith(Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads)
+{
+    if(&other == this)
+    {
+        return;
+    }
+    checkAllocators(other);
+
+    int count = size;
+    int added = other.size;
+    Node* a = root;
+    int aHeight = getHeight();
+    Node* b = other.root;
+    int bHeight = other.getHeight();
+    root = nullptr;
+    other.root = nullptr;
+    other.clear();
+
+    std::vector<Node*> garbage;
+    int height;
+    Node* tree = uniteTrees(a,aHeight,b,bHeight,height,garbage,threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+    finishSetOperation(tree,count,added,garbage);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::intersect(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads)
+{
+    if(&other == this)
+    {
+        return;
+    }
+
+    int count = size;
+    Node* a = root;
+    int aHeight = getHeight();
+    root = nullptr;
+
+    std::vector<Node*> garbage;
+    int height;
+    Node* tree = intersectTrees(a,aHeight,other.root,height,garbage,threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+    finishSetOperation(tree,count,0,garbage);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+void Dictionary<Key,Info,Compare,Allocator,Augmentation>::difference(const Dictionary<Key,Info,Compare,Allocator,Augmentation>& other, int threads)
+{
+    if(&other == this)
+    {
+        clear();
+        return;
+    }
+
+    int count = size;
+    Node* a = root;
+    int aHeight = getHeight();
+    root = nullptr;
+
+    std::vector<Node*> garbage;
+    int height;
+    Node* tree = subtractTrees(a,aHeight,other.root,height,garbage,threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+    finishSetOperation(tree,count,0,garbage);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+bool Dictionary<Key,Info,Compare,Allocator,Augmentation>::isAVL()
+{
+    bool ok = true;
+    checkSubtree(root,ok);
+    return ok && (root == nullptr || root->getParent() == nullptr);
+}
+
+template <typename Key, typename Info, typename Compare, typename Allocator, typename Augmentation>
+int Dictionary<Key,Info,Compare,Allocator,Augmentation>::checkSubtree(const Node* node, bool& ok) const
+{
+    if(node == nullptr || !ok)
+    {
+        return 0;
+    }
+
+    //children need to point back to the node and keep order of keys
+    if(node->left != nullptr && (node->left->getParent() != node || !lessThan(node->left->key,node->key)))
+    {
+        ok = false;
+    }
+    if(node->right != nullptr && (node->right->getParent() != node || !lessThan(node->key,node->right->key)))
+    {
+        ok = false;
     }
 
-    return stack;
+    //heights are calculated from the bottom of the tree
+    int left = checkSubtree(node->left,ok);
+    int right = checkSubtree(node->right,ok);
+
+    //absoulute value of bfactor can't be greater than 1
+    //if it is greater, it means that it is not AVL tree
+    //stored balance factor different than calculated one was wrongly updated during addNode or deleteNode
+    if(right - left < -1 || right - left > 1 || node->getBalance() != right - left)
+    {
+        ok = false;
+    }
+    if constexpr(counted)
+    {
+        if(node->subtreeSize != subtreeSize(node->left) + subtreeSize(node->right) + 1)
+        {
+            ok = false;
+        }
+    }
+    return std::max(left,right) + 1;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,6 @@
+#ifndef DICTIONARY_POOL_ALLOCATOR_HPP
+#define DICTIONARY_POOL_ALLOCATOR_HPP
+//the same slab pool allocator is used by both projects, it is kept in one place
+#include "../doubly-linked ring/pool_allocator.hpp"
+
+#endif
@@ -1,7 +1,12 @@
 #include <catch2/catch_all.hpp>
 #include "dictionary.hpp"
+#include "pool_allocator.hpp"
+#include <cmath>
+#include <map>
+#include <string_view>
 
-void createDictionary(Dictionary<char,int>& test, std::string str = "dbfaceg")
+template <typename Compare, typename Allocator, typename Augmentation>
+void createDictionary(Dictionary<char,int,Compare,Allocator,Augmentation>& test, std::string str = "dbfaceg")
 {
     for(std::size_t x = 0; x < str.size(); ++x)
     {
@@ -379,4 +384,1147 @@ TEST_CASE("Adding and removing with rotations")
         CHECK(test.isAVL() == true);
     }
     CHECK(test.getSize() == 0);
-}
\ No newline at end of file
+}
+TEST_CASE("Cached begin and last")
+{
+    Dictionary<char,int> test;
+    CHECK(test.begin() == test.end());
+    CHECK(test.last() == test.end());
+
+    createDictionary(test);
+    CHECK(test.begin()->first == 'a');
+    CHECK(test.last()->first == 'g');
+    CHECK(--test.end() == test.last());
+
+    //adding new extremes
+    test.addNode('0',1);
+    test.addNode('z',1);
+    CHECK(test.begin()->first == '0');
+    CHECK(test.last()->first == 'z');
+
+    //reverse scan
+    std::string str = "0abcdefgz";
+    int index = str.size() - 1;
+    for(auto it = test.last(); ; --it)
+    {
+        CHECK(it->first == str[index]);
+        --index;
+        if(it == test.begin())
+        {
+            break;
+        }
+    }
+    CHECK(index == -1);
+
+    //deleting extremes in every way
+    test.deleteNode('0');
+    CHECK(test.begin()->first == 'a');
+    test.deleteNode('z');
+    CHECK(test.last()->first == 'g');
+    test.deleteNode('a');
+    CHECK(test.begin()->first == 'b');
+    test.deleteNode('g');
+    CHECK(test.last()->first == 'f');
+
+    //extremes moved by rotations
+    std::string added = "qw1ert3yui6opas5dfg4h7jkl8zx2cv9bnm";
+    char smallest = 'b';
+    char highest = 'f';
+    for(char c : added)
+    {
+        test.addNode(c,1);
+        smallest = std::min(smallest,c);
+        highest = std::max(highest,c);
+        CHECK(test.begin()->first == smallest);
+        CHECK(test.last()->first == highest);
+    }
+    for(char c : std::string("1z2y3x"))
+    {
+        test.deleteNode(c);
+        auto it = test.begin();
+        CHECK_THROWS(--it);
+        CHECK(test.isAVL());
+    }
+    CHECK(test.begin()->first == '4');
+    CHECK(test.last()->first == 'w');
+
+    test.clear();
+    CHECK(test.begin() == test.end());
+    CHECK(test.last() == test.end());
+}
+
+TEST_CASE("Copying big dictionary")
+{
+    Dictionary<int,int> test;
+    for(int x = 0; x < 10000; ++x)
+    {
+        test.addNode((x * 7919) % 10007,x);
+    }
+
+    Dictionary<int,int> test2(test);
+    CHECK(test2.getSize() == 10000);
+    CHECK(test2.getHeight() == test.getHeight());
+    CHECK(test2.isAVL());
+    CHECK(test2.begin()->first == test.begin()->first);
+    CHECK(test2.last()->first == test.last()->first);
+
+    //the same shape and elements
+    auto it2 = test2.begin();
+    for(auto it = test.begin(); it != test.end(); ++it, ++it2)
+    {
+        CHECK(it->first == it2->first);
+        CHECK(it->second == it2->second);
+        CHECK(it.isLeaf() == it2.isLeaf());
+        CHECK(it.isParentPossible() == it2.isParentPossible());
+    }
+    CHECK(it2 == test2.end());
+
+    //copy can be changed independently
+    test2.deleteNode(test2.top());
+    CHECK(test2.isAVL());
+    CHECK(test.getSize() == 10000);
+    CHECK(test.isAVL());
+}
+
+TEST_CASE("Clearing big dictionary")
+{
+    Dictionary<int,int> test;
+    for(int x = 0; x < 100000; ++x)
+    {
+        test.addNode(x,x);
+    }
+    test.clear();
+    CHECK(test.getSize() == 0);
+    CHECK(test.getHeight() == 0);
+    CHECK(test.top().isEnd());
+    CHECK(test.begin() == test.end());
+    CHECK(test.isAVL());
+
+    //dictionary can be used after clearing
+    test.addNode(5,1);
+    test.addNode(3,1);
+    CHECK(test.getSize() == 2);
+    CHECK(test.begin()->first == 3);
+    CHECK(test.isAVL());
+}
+
+//info, which counts its copies, moves are not counted
+struct CopyCounter
+{
+    static inline int copies = 0;
+    int value;
+
+    CopyCounter(int v) : value(v){};
+    CopyCounter(const CopyCounter& other) : value(other.value) {++copies;};
+    CopyCounter(CopyCounter&&) noexcept = default;
+    CopyCounter& operator=(const CopyCounter& other) {value = other.value; ++copies; return *this;};
+    CopyCounter& operator=(CopyCounter&&) noexcept = default;
+};
+
+TEST_CASE("Building from sorted range")
+{
+    std::vector<std::pair<int,int>> sorted;
+    for(int x = 0; x < 1000; ++x)
+    {
+        sorted.emplace_back(x,x * 2);
+    }
+
+    Dictionary<int,int> test(sorted.begin(),sorted.end());
+    CHECK(test.getSize() == 1000);
+    CHECK(test.isAVL());
+    //perfectly balanced tree
+    CHECK(test.getHeight() == 10);
+    CHECK(test.begin()->first == 0);
+    CHECK(test.last()->first == 999);
+    CHECK(test.find(500)->second == 1000);
+
+    int index = 0;
+    for(auto it = test.begin(); it != test.end(); ++it)
+    {
+        CHECK(it->first == index);
+        ++index;
+    }
+    CHECK(index == 1000);
+
+    //tree can be changed later
+    test.deleteNode(0);
+    test.addNode(-1,0);
+    CHECK(test.isAVL());
+
+    //unsorted input is rejected, dictionary is not changed
+    std::vector<std::pair<char,int>> unsorted = {{'d',1},{'b',2},{'f',3},{'b',4},{'a',5}};
+    Dictionary<char,int> test2;
+    createDictionary(test2);
+    CHECK_THROWS(test2.buildFromSorted(unsorted.begin(),unsorted.end()));
+    CHECK(test2.getSize() == 7);
+
+    //or sorted, the first element with every key is taken
+    test2.buildFromSorted(unsorted.begin(),unsorted.end(),true);
+    CHECK(test2.getSize() == 4);
+    CHECK(test2.isAVL());
+    CHECK(test2.find('b')->second == 2);
+    CHECK(test2.begin()->first == 'a');
+    CHECK(test2.last()->first == 'f');
+
+    //elements are copied from the range once, then moved from the sorted copy into nodes
+    std::vector<std::pair<int,CopyCounter>> counters;
+    for(int x : {5, 3, 9, 3, 1, 7})
+    {
+        counters.emplace_back(x,CopyCounter(x));
+    }
+    CopyCounter::copies = 0;
+    Dictionary<int,CopyCounter> test3;
+    test3.buildFromSorted(counters.begin(),counters.end(),true);
+    CHECK(test3.getSize() == 5);
+    CHECK(test3.isAVL());
+    CHECK(test3.find(9)->second.value == 9);
+    CHECK(CopyCounter::copies == 6);
+
+    //empty range
+    test2.buildFromSorted(unsorted.end(),unsorted.end());
+    CHECK(test2.getSize() == 0);
+    CHECK(test2.begin() == test2.end());
+}
+
+TEST_CASE("Allocators and compacting")
+{
+    //pool allocator
+    PoolAllocator<int> allocator;
+    Dictionary<int,int,std::less<int>,PoolAllocator<int>> test(allocator);
+    for(int x = 0; x < 2000; ++x)
+    {
+        test.addNode(x,x);
+    }
+    CHECK(test.getSize() == 2000);
+    CHECK(test.isAVL());
+
+    //deleted node is reused by the next add
+    const int* address = &test.find(1999)->second;
+    test.deleteNode(1999);
+    test.addNode(5000,1);
+    CHECK(&test.find(5000)->second == address);
+
+    //copy shares the pool, its nodes leave holes in the pool when it's cleared
+    Dictionary<int,int,std::less<int>,PoolAllocator<int>> test2(test);
+    CHECK(test2.getAllocator() == test.getAllocator());
+    test2.clear();
+
+    //nodes of neighbouring elements lie one after another
+    auto inOrder = [](const Dictionary<int,int,std::less<int>,PoolAllocator<int>>& dictionary)
+    {
+        auto it = dictionary.begin();
+        const int* previous = &it->second;
+        bool ordered = true;
+        for(++it; it != dictionary.end(); ++it)
+        {
+            ordered = ordered && &it->second > previous;
+            previous = &it->second;
+        }
+        return ordered;
+    };
+
+    //scatter nodes, then compact them in order
+    //new nodes don't go into the holes
+    for(int x = 0; x < 2000; x += 2)
+    {
+        test.deleteNode(x);
+    }
+    for(int x = 0; x < 2000; x += 2)
+    {
+        test.addNode(x,x);
+    }
+    CHECK_FALSE(inOrder(test));
+    test.compact();
+    CHECK(test.getSize() == 2000);
+    CHECK(test.isAVL());
+    CHECK(test.getHeight() == 11);
+    CHECK(test.begin()->first == 0);
+    CHECK(test.last()->first == 5000);
+    CHECK(inOrder(test));
+
+    //breadth first layout, root is in the first node
+    //nodes freed by the previous compact are holes now
+    test.compact(Dictionary<int,int,std::less<int>,PoolAllocator<int>>::Layout::BFS);
+    CHECK(test.getSize() == 2000);
+    CHECK(test.isAVL());
+    CHECK(&test.top()->second < &test.begin()->second);
+    CHECK(&test.top().getLeft()->second < &test.top().getRight()->second);
+    int index = 0;
+    for(auto x = test.begin(); x != test.end(); ++x)
+    {
+        CHECK(x->first == (index < 1999 ? index : 5000));
+        ++index;
+    }
+    CHECK(test.find(5000)->second == 1);
+
+    //more nodes deleted than added, free list is full of holes
+    Dictionary<int,int,std::less<int>,PoolAllocator<int>> sparse;
+    for(int x = 0; x < 4000; ++x)
+    {
+        sparse.addNode(x,x);
+    }
+    for(int x = 0; x < 4000; x += 2)
+    {
+        sparse.deleteNode(x);
+    }
+    sparse.addNode(0,0);
+    sparse.compact();
+    CHECK(sparse.getSize() == 2001);
+    CHECK(sparse.isAVL());
+    CHECK(inOrder(sparse));
+    //holes are still reused by adding
+    const int* hole = &sparse.find(1)->second;
+    sparse.deleteNode(1);
+    sparse.addNode(2,2);
+    CHECK(&sparse.find(2)->second == hole);
+
+    //polymorphic allocator
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer,sizeof(buffer));
+    PmrDictionary<char,int> test3(&arena);
+    createDictionary(test3);
+    CHECK(test3.getSize() == 7);
+    CHECK(test3.isAVL());
+    CHECK(test3.getAllocator().resource() == &arena);
+    PmrDictionary<char,int> test4(test3);
+    test4 = test3;
+    CHECK(test4.getSize() == 7);
+}
+
+//allocator, which throws std::bad_alloc once given number of allocations is used
+long long allocationsLeft = -1;
+
+template <typename T>
+struct LimitedAllocator
+{
+    using value_type = T;
+
+    LimitedAllocator() = default;
+    template <typename U>
+    LimitedAllocator(const LimitedAllocator<U>&){};
+
+    T* allocate(std::size_t n)
+    {
+        if(allocationsLeft == 0)
+        {
+            throw std::bad_alloc();
+        }
+        if(allocationsLeft > 0)
+        {
+            --allocationsLeft;
+        }
+        return std::allocator<T>().allocate(n);
+    };
+    void deallocate(T* pointer, std::size_t n) {std::allocator<T>().deallocate(pointer,n);};
+    template <typename U>
+    bool operator==(const LimitedAllocator<U>&) const {return true;};
+    template <typename U>
+    bool operator!=(const LimitedAllocator<U>&) const {return false;};
+};
+
+TEST_CASE("Failed compacting keeps elements")
+{
+    using Limited = Dictionary<int,std::string,std::less<int>,LimitedAllocator<std::pair<const int,std::string>>>;
+    Limited test;
+    for(int x = 0; x < 100; ++x)
+    {
+        test.addNode(x,std::to_string(x));
+    }
+
+    for(auto layout : {Limited::Layout::IN_ORDER, Limited::Layout::BFS})
+    {
+        //allocation fails in the middle of building new tree
+        allocationsLeft = 50;
+        CHECK_THROWS_AS(test.compact(layout),std::bad_alloc);
+        allocationsLeft = -1;
+        CHECK(test.getSize() == 100);
+        CHECK(test.isAVL());
+        int x = 0;
+        for(auto it = test.begin(); it != test.end(); ++it, ++x)
+        {
+            CHECK(it->first == x);
+            CHECK(it->second == std::to_string(x));
+        }
+        CHECK(x == 100);
+
+        test.compact(layout);
+        CHECK(test.getSize() == 100);
+        CHECK(test.find(42)->second == "42");
+    }
+}
+
+TEST_CASE("Random adding and removing")
+{
+    //balance factors are kept in nodes without heights
+    //every change is checked against tree built from scratch
+    Dictionary<int,int> test;
+    std::vector<bool> inside(500,false);
+    int size = 0;
+    unsigned seed = 12345;
+    for(int x = 0; x < 5000; ++x)
+    {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 8) % 500;
+        if(inside[key])
+        {
+            CHECK(test.deleteNode(key));
+            --size;
+        }
+        else
+        {
+            CHECK(test.addNode(key,key));
+            ++size;
+        }
+        inside[key] = !inside[key];
+        CHECK(test.isAVL());
+    }
+    CHECK(test.getSize() == size);
+
+    int previous = -1;
+    int count = 0;
+    for(auto it = test.begin(); it != test.end(); ++it)
+    {
+        CHECK(inside[it->first]);
+        CHECK(it->first > previous);
+        previous = it->first;
+        ++count;
+    }
+    CHECK(count == size);
+
+    //height of AVL tree is at most 1.44 log2(n)
+    CHECK(test.getHeight() <= 1.45 * std::log2(size + 2));
+}
+
+TEST_CASE("Rebalancing stops early")
+{
+    Dictionary<int,int> test;
+    CHECK(test.getRebalanceStats().rotations == 0);
+
+    //every add to sorted tree is done at the end, the worst case for walking up to the root
+    const int n = 1 << 14;
+    for(int x = 0; x < n; ++x)
+    {
+        test.addNode(x,x);
+    }
+    auto stats = test.getRebalanceStats();
+    CHECK(stats.retraces == n - 1);
+    CHECK(stats.rotations > 0);
+    //walk to the root would visit about n * log2(n) nodes
+    CHECK(stats.retracedNodes < 3 * n);
+    CHECK(stats.maxRetraceDepth <= test.getHeight());
+
+    //single add walks at most to the root
+    test.resetRebalanceStats();
+    CHECK(test.getRebalanceStats().retracedNodes == 0);
+    test.addNode(-1,0);
+    CHECK(test.getRebalanceStats().retracedNodes <= test.getHeight());
+
+    test.resetRebalanceStats();
+    for(int x = 0; x < n; x += 2)
+    {
+        test.deleteNode(x);
+    }
+    stats = test.getRebalanceStats();
+    CHECK(stats.retraces == n / 2);
+    CHECK(stats.retracedNodes < 3 * n);
+    CHECK(test.isAVL());
+}
+
+//three-way comparator counting its calls
+struct CountingCompare
+{
+    int* calls;
+    int operator()(int a, int b) const
+    {
+        ++(*calls);
+        return a < b ? -1 : (a > b ? 1 : 0);
+    };
+};
+
+#ifdef DICTIONARY_THREE_WAY_OPERATOR
+//key, which counts every comparison, both by operator< and operator<=>
+struct CountedKey
+{
+    int value;
+    int* calls;
+
+    bool operator<(const CountedKey& other) const {++(*calls); return value < other.value;};
+    std::strong_ordering operator<=>(const CountedKey& other) const {++(*calls); return value <=> other.value;};
+    bool operator==(const CountedKey& other) const {return value == other.value;};
+};
+#endif
+
+TEST_CASE("Comparators and heterogeneous lookup")
+{
+    //reversed order
+    Dictionary<char,int,std::greater<char>> reversed;
+    createDictionary(reversed);
+    CHECK(reversed.isAVL());
+    CHECK(reversed.begin()->first == 'g');
+    CHECK(reversed.last()->first == 'a');
+    CHECK(reversed.find('c')->first == 'c');
+    CHECK_FALSE(reversed.addNode('c',2));
+    CHECK(reversed.find('z') == reversed.end());
+
+    //string keys found by string_view, no std::string is created
+    Dictionary<std::string,int,std::less<>> words;
+    words.addNode("banana",2);
+    words.addNode("apple",1);
+    words.addNode("cherry",3);
+    std::string_view key = "cherry";
+    CHECK(words.find(key)->second == 3);
+    CHECK(words.find(std::string_view("apple"))->second == 1);
+    CHECK(words.find(std::string_view("apples")) == words.end());
+    CHECK(words.find(std::string("banana"))->second == 2);
+
+    //three-way comparison with compare method of strings
+    Dictionary<std::string,int,ThreeWayCompare> words2;
+    for(std::string word : {"dog","cat","emu","ant","cow","elk","yak"})
+    {
+        CHECK(words2.addNode(word,1));
+    }
+    CHECK_FALSE(words2.addNode("cow",2));
+    CHECK(words2.isAVL());
+    CHECK(words2.begin()->first == "ant");
+    CHECK(words2.find(std::string_view("elk")) != words2.end());
+    CHECK(words2.find("owl") == words2.end());
+    CHECK(words2.deleteNode("cat"));
+    CHECK(words2.getSize() == 6);
+
+    //one comparison on every level
+    int calls = 0;
+    Dictionary<int,int,CountingCompare> counted(CountingCompare{&calls});
+    for(int x = 0; x < 1023; ++x)
+    {
+        counted.addNode(x,x);
+    }
+    CHECK(counted.isAVL());
+    calls = 0;
+    counted.find(0);
+    CHECK(calls <= counted.getHeight());
+    calls = 0;
+    counted.find(5000);
+    CHECK(calls <= counted.getHeight());
+    //the root is found with a single comparison
+    calls = 0;
+    counted.find(counted.top()->first);
+    CHECK(calls == 1);
+
+#ifdef DICTIONARY_THREE_WAY_OPERATOR
+    //std::less of keys with operator<=> compares once on every level too
+    int keyCalls = 0;
+    Dictionary<CountedKey,int> spaceship;
+    for(int x = 0; x < 1023; ++x)
+    {
+        spaceship.addNode(CountedKey{x,&keyCalls},x);
+    }
+    CHECK(spaceship.isAVL());
+    keyCalls = 0;
+    spaceship.find(spaceship.top()->first);
+    CHECK(keyCalls == 1);
+    keyCalls = 0;
+    CHECK(spaceship.find(CountedKey{700,&keyCalls})->second == 700);
+    CHECK(keyCalls <= spaceship.getHeight());
+    keyCalls = 0;
+    CHECK(spaceship.find(CountedKey{5000,&keyCalls}) == spaceship.end());
+    CHECK(keyCalls <= spaceship.getHeight());
+#endif
+}
+
+TEST_CASE("Emplacing, assigning and upserting")
+{
+    Dictionary<std::string,std::string> test;
+
+    //info is constructed from arguments
+    auto result = test.tryEmplace("key",3,'x');
+    CHECK(result.second);
+    CHECK(result.first->first == "key");
+    CHECK(result.first->second == "xxx");
+
+    //existing element is not changed
+    result = test.tryEmplace("key",5,'y');
+    CHECK_FALSE(result.second);
+    CHECK(result.first->second == "xxx");
+    CHECK(test.getSize() == 1);
+
+    std::string key = "moved";
+    result = test.tryEmplace(std::move(key),"value");
+    CHECK(result.second);
+    CHECK(test.find("moved")->second == "value");
+
+    //insertOrAssign replaces info
+    result = test.insertOrAssign("key","new");
+    CHECK_FALSE(result.second);
+    CHECK(test.find("key")->second == "new");
+    result = test.insertOrAssign("other","value");
+    CHECK(result.second);
+    CHECK(test.getSize() == 3);
+    CHECK(test.isAVL());
+
+    //counting words with upsert
+    Dictionary<std::string,int> counts;
+    std::string text[] = {"a","b","a","c","a","b"};
+    for(const std::string& word : text)
+    {
+        counts.upsert(word,[](int& count){++count;});
+    }
+    CHECK(counts.getSize() == 3);
+    CHECK(counts.find("a")->second == 3);
+    CHECK(counts.find("b")->second == 2);
+    CHECK(counts.find("c")->second == 1);
+
+    auto it = counts.upsert("d",[](int& count){count += 10;});
+    CHECK(it->first == "d");
+    CHECK(it->second == 10);
+    CHECK(counts.last() == it);
+
+    //a lot of elements with rotations
+    Dictionary<int,int> numbers;
+    for(int x = 0; x < 1000; ++x)
+    {
+        numbers.upsert(x % 100,[x](int& sum){sum += x;});
+    }
+    CHECK(numbers.getSize() == 100);
+    CHECK(numbers.isAVL());
+    CHECK(numbers.find(7)->second == 7 * 10 + 4500);
+}
+
+TEST_CASE("Order statistics")
+{
+    using Ranked = Dictionary<int,int,std::less<int>,std::allocator<std::pair<const int,int>>,OrderStatistics>;
+    SECTION("Rank and select")
+    {
+        Ranked test;
+        CHECK(test.rank(5) == 0);
+        CHECK(test.select(0) == test.end());
+        CHECK_THROWS_AS(test.select(1),std::invalid_argument);
+
+        //even keys from 0 to 998
+        for(int i = 499; i >= 0; --i)
+        {
+            test.addNode(2 * i,i);
+        }
+        CHECK(test.isAVL());
+        for(int i = 0; i < 500; ++i)
+        {
+            CHECK(test.rank(2 * i) == i);
+            CHECK(test.rank(2 * i + 1) == i + 1);
+            CHECK(test.select(i)->first == 2 * i);
+        }
+        CHECK(test.rank(-1) == 0);
+        CHECK(test.select(500) == test.end());
+        CHECK_THROWS_AS(test.select(501),std::invalid_argument);
+        CHECK_THROWS_AS(test.select(-1),std::invalid_argument);
+    }
+
+    SECTION("Iterator jumps")
+    {
+        Dictionary<char,int,std::less<char>,std::allocator<std::pair<const char,int>>,OrderStatistics> test;
+        createDictionary(test);
+        //a b c d e f g
+        auto it = test.begin() + 3;
+        CHECK(it->first == 'd');
+        it += 3;
+        CHECK(it->first == 'g');
+        CHECK(it + 1 == test.end());
+        CHECK_THROWS_AS(it + 2,std::logic_error);
+        CHECK((test.end() - 7)->first == 'a');
+        CHECK_THROWS_AS(test.end() - 8,std::logic_error);
+        it -= 4;
+        CHECK(it->first == 'c');
+        CHECK((it + -2)->first == 'a');
+        CHECK((it + 0)->first == 'c');
+        CHECK_THROWS_AS(decltype(it)() + 1,std::logic_error);
+    }
+
+    SECTION("Sizes are maintained")
+    {
+        Ranked test;
+        std::vector<int> keys;
+        unsigned int seed = 12345;
+        for(int i = 0; i < 3000; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            int key = static_cast<int>(seed / 65536 % 1000);
+            if(seed % 3 == 0)
+            {
+                test.deleteNode(key);
+            }
+            else
+            {
+                test.upsert(key,[](int& count){++count;});
+            }
+        }
+        CHECK(test.isAVL());
+        int index = 0;
+        for(auto it = test.begin(); it != test.end(); ++it, ++index)
+        {
+            CHECK(test.rank(it->first) == index);
+            CHECK(test.select(index) == it);
+        }
+        CHECK(index == test.getSize());
+
+        //copy, build and compact keep sizes
+        Ranked copied(test);
+        CHECK(copied.isAVL());
+        CHECK(copied.select(index / 2)->first == test.select(index / 2)->first);
+
+        test.compact(Ranked::Layout::BFS);
+        CHECK(test.isAVL());
+        CHECK(test.select(index / 2)->first == copied.select(index / 2)->first);
+
+        std::vector<std::pair<int,int>> elements;
+        for(int i = 0; i < 100; ++i)
+        {
+            elements.emplace_back(i,i);
+        }
+        test.buildFromSorted(elements.begin(),elements.end());
+        CHECK(test.isAVL());
+        CHECK(test.select(42)->second == 42);
+
+        test.clear();
+        CHECK(test.select(0) == test.end());
+        test.addNode(1,1);
+        CHECK(test.rank(2) == 1);
+    }
+}
+
+TEST_CASE("Bounds and ranges")
+{
+    Dictionary<int,std::string> test;
+    //keys 10, 20, ..., 100
+    for(int i = 10; i >= 1; --i)
+    {
+        test.addNode(10 * i,std::to_string(i));
+    }
+
+    CHECK(test.lowerBound(30)->first == 30);
+    CHECK(test.lowerBound(31)->first == 40);
+    CHECK(test.lowerBound(-5) == test.begin());
+    CHECK(test.lowerBound(101) == test.end());
+    CHECK(test.upperBound(30)->first == 40);
+    CHECK(test.upperBound(29)->first == 30);
+    CHECK(test.upperBound(100) == test.end());
+
+    CHECK(test.floor(30)->first == 30);
+    CHECK(test.floor(39)->first == 30);
+    CHECK(test.floor(1000) == test.last());
+    CHECK(test.floor(9) == test.end());
+    CHECK(test.ceiling(39)->first == 40);
+    CHECK(test.ceiling(100)->first == 100);
+
+    //the same as lowerBound and upperBound
+    for(int k : {-5, 10, 30, 31, 99, 100, 101})
+    {
+        auto equal = test.equalRange(k);
+        CHECK(equal.first == test.lowerBound(k));
+        CHECK(equal.second == test.upperBound(k));
+    }
+    CHECK(test.equalRange(30).first->second == "3");
+    CHECK(test.equalRange(35).first == test.equalRange(35).second);
+
+    SECTION("Range view")
+    {
+        std::vector<int> keys;
+        for(auto& element : test.range(25,70))
+        {
+            keys.push_back(element.first);
+        }
+        CHECK(keys == std::vector<int>{30,40,50,60});
+
+        //upper bound is excluded, lower one included
+        keys.clear();
+        for(auto& element : test.range(30,31))
+        {
+            keys.push_back(element.first);
+        }
+        CHECK(keys == std::vector<int>{30});
+
+        auto all = test.range(0,1000);
+        CHECK(all.begin() == test.begin());
+        CHECK(all.end() == test.end());
+
+        CHECK(test.range(41,49).isEmpty());
+        CHECK(test.range(70,25).isEmpty());
+        CHECK(test.range(50,50).isEmpty());
+        CHECK(test.range(200,300).isEmpty());
+
+        //info can be changed through the view
+        for(auto& element : test.range(90,1000))
+        {
+            element.second = "last";
+        }
+        CHECK(test.find(90)->second == "last");
+        CHECK(test.find(100)->second == "last");
+        CHECK(test.find(80)->second == "8");
+    }
+
+    SECTION("Empty dictionary")
+    {
+        Dictionary<int,int> empty;
+        CHECK(empty.lowerBound(1) == empty.end());
+        CHECK(empty.upperBound(1) == empty.end());
+        CHECK(empty.floor(1) == empty.end());
+        CHECK(empty.equalRange(1).first == empty.end());
+        CHECK(empty.equalRange(1).second == empty.end());
+        CHECK(empty.range(0,10).isEmpty());
+    }
+}
+
+//monoid, which is not commutative, checks order of aggregated infos
+struct InfoConcatenation
+{
+    using Value = std::string;
+    static Value identity() {return "";};
+    static Value lift(const std::string& info) {return info;};
+    static Value combine(const Value& a, const Value& b) {return a + b;};
+};
+
+template <typename Monoid>
+using AggregatedDictionary = Dictionary<int,typename Monoid::Value,std::less<int>,
+                                        std::allocator<std::pair<const int,typename Monoid::Value>>,Aggregation<Monoid>>;
+
+TEST_CASE("Aggregating ranges of keys")
+{
+    SECTION("Sum, count, min and max")
+    {
+        AggregatedDictionary<InfoSum<long long>> sums;
+        AggregatedDictionary<InfoCount<int>> counts;
+        AggregatedDictionary<InfoMin<int>> mins;
+        AggregatedDictionary<InfoMax<int>> maxes;
+        CHECK(sums.aggregate() == 0);
+        CHECK(mins.aggregate(0,10) == std::numeric_limits<int>::max());
+
+        //values change with keys, so every range has different result
+        std::map<int,int> model;
+        unsigned int seed = 777;
+        for(int i = 0; i < 2000; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            int key = static_cast<int>(seed / 65536 % 500);
+            int value = static_cast<int>(seed % 1000) - 500;
+            if(i % 4 == 3)
+            {
+                sums.deleteNode(key);
+                counts.deleteNode(key);
+                mins.deleteNode(key);
+                maxes.deleteNode(key);
+                model.erase(key);
+            }
+            else
+            {
+                sums.insertOrAssign(key,value);
+                counts.insertOrAssign(key,value);
+                mins.insertOrAssign(key,value);
+                maxes.insertOrAssign(key,value);
+                model[key] = value;
+            }
+        }
+        CHECK(sums.isAVL());
+
+        for(int lo = -10; lo < 510; lo += 37)
+        {
+            for(int hi = lo; hi < 520; hi += 53)
+            {
+                long long sum = 0;
+                long long count = 0;
+                int min = std::numeric_limits<int>::max();
+                int max = std::numeric_limits<int>::lowest();
+                for(auto it = model.lower_bound(lo); it != model.end() && it->first < hi; ++it)
+                {
+                    sum += it->second;
+                    ++count;
+                    min = std::min(min,it->second);
+                    max = std::max(max,it->second);
+                }
+                CHECK(sums.aggregate(lo,hi) == sum);
+                CHECK(counts.aggregate(lo,hi) == count);
+                CHECK(mins.aggregate(lo,hi) == min);
+                CHECK(maxes.aggregate(lo,hi) == max);
+            }
+        }
+        CHECK(counts.aggregate() == static_cast<long long>(model.size()));
+        CHECK(counts.aggregate(100,50) == 0);
+    }
+
+    SECTION("Order of infos")
+    {
+        AggregatedDictionary<InfoConcatenation> test;
+        std::string letters = "dbfacegihkjml";
+        for(char letter : letters)
+        {
+            test.addNode(letter - 'a',std::string(1,letter));
+        }
+        CHECK(test.aggregate() == "abcdefghijklm");
+        CHECK(test.aggregate(2,7) == "cdefg");
+        CHECK(test.aggregate(-5,1) == "a");
+        CHECK(test.aggregate(12,100) == "m");
+
+        //info changed in place is aggregated again
+        test.upsert(3,[](std::string& info){info = "D";});
+        CHECK(test.aggregate(0,5) == "abcDe");
+        test.deleteNode(1);
+        CHECK(test.aggregate(0,5) == "acDe");
+
+        //copy and compact keep aggregates
+        AggregatedDictionary<InfoConcatenation> copied(test);
+        CHECK(copied.aggregate(2,7) == "cDefg");
+        test.compact(AggregatedDictionary<InfoConcatenation>::Layout::BFS);
+        CHECK(test.aggregate() == "acDefghijklm");
+        test.compact();
+        CHECK(test.aggregate(5,9) == "fghi");
+    }
+}
+
+TEST_CASE("Joining and splitting")
+{
+    //split takes sizes of parts from OrderStatistics
+    using Ranked = Dictionary<int,int,std::less<int>,std::allocator<std::pair<const int,int>>,OrderStatistics>;
+
+    SECTION("Split and join again")
+    {
+        Ranked test;
+        for(int i = 0; i < 1000; ++i)
+        {
+            test.addNode(i,i * i);
+        }
+
+        for(int k : {-5, 0, 1, 317, 500, 999, 1000, 2000})
+        {
+            Ranked greater;
+            greater.addNode(5000,0);
+            test.split(k,greater);
+            CHECK(test.isAVL());
+            CHECK(greater.isAVL());
+            int expected = std::min(std::max(k,0),1000);
+            CHECK(test.getSize() == expected);
+            CHECK(greater.getSize() == 1000 - expected);
+            CHECK(greater.find(5000) == greater.end());
+            if(expected > 0)
+            {
+                CHECK(test.last()->first == expected - 1);
+            }
+            if(expected < 1000)
+            {
+                CHECK(greater.begin()->first == expected);
+                CHECK(greater.find(expected)->second == expected * expected);
+            }
+
+            test.join(greater);
+            CHECK(greater.getSize() == 0);
+            CHECK(test.getSize() == 1000);
+            CHECK(test.isAVL());
+        }
+        int i = 0;
+        for(auto it = test.begin(); it != test.end(); ++it, ++i)
+        {
+            CHECK(it->first == i);
+        }
+    }
+
+    SECTION("Join with middle element")
+    {
+        //trees of very different heights
+        Dictionary<int,int> left;
+        Dictionary<int,int> right;
+        for(int i = 0; i < 3; ++i)
+        {
+            left.addNode(i,0);
+        }
+        for(int i = 100; i < 5000; ++i)
+        {
+            right.addNode(i,0);
+        }
+        left.join(50,1,right);
+        CHECK(left.isAVL());
+        CHECK(left.getSize() == 4904);
+        CHECK(right.getSize() == 0);
+        CHECK(left.find(50)->second == 1);
+        CHECK(left.begin()->first == 0);
+        CHECK(left.last()->first == 4999);
+
+        //and the other way round
+        Dictionary<int,int> big;
+        Dictionary<int,int> small;
+        for(int i = 0; i < 5000; ++i)
+        {
+            big.addNode(i,0);
+        }
+        small.addNode(6000,0);
+        big.join(5500,0,small);
+        CHECK(big.isAVL());
+        CHECK(big.getSize() == 5002);
+
+        Dictionary<int,int> empty;
+        Dictionary<int,int> empty2;
+        empty.join(1,1,empty2);
+        CHECK(empty.getSize() == 1);
+        CHECK(empty.isAVL());
+
+        //keys out of order
+        Dictionary<int,int> other;
+        other.addNode(3,0);
+        CHECK_THROWS_AS(big.join(7000,0,other),std::invalid_argument);
+        CHECK_THROWS_AS(big.join(other),std::invalid_argument);
+        CHECK_THROWS_AS(big.join(big),std::invalid_argument);
+        CHECK(other.getSize() == 1);
+        CHECK(big.getSize() == 5002);
+    }
+
+    SECTION("Allocators have to be equal")
+    {
+        using Pooled = Dictionary<int,int,std::less<int>,PoolAllocator<int>>;
+        Pooled first;
+        Pooled second;
+        first.addNode(1,1);
+        second.addNode(2,2);
+        CHECK_THROWS_AS(first.join(second),std::invalid_argument);
+        CHECK_THROWS_AS(first.unionWith(second),std::invalid_argument);
+
+        Pooled shared(first.getAllocator());
+        shared.addNode(3,3);
+        first.join(shared);
+        CHECK(first.getSize() == 2);
+    }
+
+    SECTION("Sizes after split are exact")
+    {
+        Ranked test;
+        for(int i = 0; i < 300; ++i)
+        {
+            test.addNode(i,i);
+        }
+        Ranked greater;
+        test.split(250,greater);
+        Ranked middle;
+        test.split(100,middle);
+        CHECK(test.getSize() == 100);
+        CHECK(middle.getSize() == 150);
+        CHECK(greater.getSize() == 50);
+
+        //sizes are used directly by set operations
+        middle.unionWith(greater);
+        CHECK(middle.getSize() == 200);
+        middle.intersect(test);
+        CHECK(middle.getSize() == 0);
+        test.unionWith(greater);
+        CHECK(test.getSize() == 100);
+    }
+
+    SECTION("Sizes with order statistics")
+    {
+        Ranked test;
+        for(int i = 0; i < 500; ++i)
+        {
+            test.addNode(i,i);
+        }
+        Ranked greater;
+        test.split(123,greater);
+        CHECK(test.isAVL());
+        CHECK(greater.isAVL());
+        CHECK(test.getSize() == 123);
+        CHECK(greater.select(0)->first == 123);
+        CHECK(greater.rank(200) == 77);
+        test.join(greater);
+        CHECK(test.select(321)->first == 321);
+    }
+}
+
+TEST_CASE("Set operations")
+{
+    //keys divisible by a and b from given range
+    auto create = [](Dictionary<int,int>& dictionary, int step, int count, int info)
+    {
+        for(int i = 0; i < count; ++i)
+        {
+            dictionary.addNode(i * step,info);
+        }
+    };
+    auto keys = [](const Dictionary<int,int>& dictionary)
+    {
+        std::vector<int> result;
+        for(auto it = dictionary.begin(); it != dictionary.end(); ++it)
+        {
+            result.push_back(it->first);
+        }
+        return result;
+    };
+
+    //many threads are checked also on machine with one core
+    for(int threads : {1, 4})
+    {
+        Dictionary<int,int> twos;
+        Dictionary<int,int> threes;
+        create(twos,2,60000,2);
+        create(threes,3,40000,3);
+        std::map<int,int> expectedUnion;
+        std::vector<int> expectedIntersection;
+        std::vector<int> expectedDifference;
+        for(int i = 0; i < 120000; ++i)
+        {
+            if(i % 2 == 0)
+            {
+                expectedUnion[i] = 2;
+            }
+            else if(i % 3 == 0)
+            {
+                expectedUnion[i] = 3;
+            }
+            if(i % 6 == 0)
+            {
+                expectedIntersection.push_back(i);
+            }
+            if(i % 2 == 0 && i % 3 != 0)
+            {
+                expectedDifference.push_back(i);
+            }
+        }
+
+        Dictionary<int,int> intersection(twos);
+        intersection.intersect(threes,threads);
+        CHECK(intersection.isAVL());
+        CHECK(keys(intersection) == expectedIntersection);
+        CHECK(intersection.getSize() == static_cast<int>(expectedIntersection.size()));
+
+        Dictionary<int,int> difference(twos);
+        difference.difference(threes,threads);
+        CHECK(difference.isAVL());
+        CHECK(keys(difference) == expectedDifference);
+        CHECK(difference.getSize() == static_cast<int>(expectedDifference.size()));
+
+        twos.unionWith(threes,threads);
+        CHECK(twos.isAVL());
+        CHECK(threes.getSize() == 0);
+        CHECK(twos.getSize() == static_cast<int>(expectedUnion.size()));
+        bool same = true;
+        auto expected = expectedUnion.begin();
+        for(auto it = twos.begin(); it != twos.end(); ++it, ++expected)
+        {
+            same = same && it->first == expected->first && it->second == expected->second;
+        }
+        CHECK(same);
+    }
+
+    SECTION("Small and empty dictionaries")
+    {
+        Dictionary<int,int> test;
+        Dictionary<int,int> empty;
+        create(test,1,10,0);
+        test.unionWith(empty);
+        CHECK(test.getSize() == 10);
+        test.difference(empty);
+        CHECK(test.getSize() == 10);
+        test.intersect(test);
+        CHECK(test.getSize() == 10);
+        test.intersect(empty);
+        CHECK(test.getSize() == 0);
+        CHECK(test.begin() == test.end());
+
+        create(test,1,10,0);
+        empty.unionWith(test);
+        CHECK(empty.getSize() == 10);
+        CHECK(test.getSize() == 0);
+        empty.difference(empty);
+        CHECK(empty.getSize() == 0);
+    }
+}
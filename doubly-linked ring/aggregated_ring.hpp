@@ -0,0 +1,290 @@
+#ifndef AGGREGATED_RING_HPP
+#define AGGREGATED_RING_HPP
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "ring.hpp"
+
+//monoids used by AggregatedRing
+//every monoid gives type of aggregate, identity element, conversion of single element and associative combine
+//invertible monoids give also inverse, they need to be commutative
+template <typename T>
+struct RingSum
+{
+    using Value = T;
+    static constexpr bool invertible = true;
+    static Value identity() {return T();};
+    static Value lift(const T& data) {return data;};
+    static Value combine(const Value& a, const Value& b) {return a + b;};
+    static Value inverse(const Value& a) {return -a;};
+};
+
+template <typename T>
+struct RingCount
+{
+    using Value = long long;
+    static constexpr bool invertible = true;
+    static Value identity() {return 0;};
+    static Value lift(const T&) {return 1;};
+    static Value combine(const Value& a, const Value& b) {return a + b;};
+    static Value inverse(const Value& a) {return -a;};
+};
+
+template <typename T>
+struct RingMin
+{
+    using Value = T;
+    static constexpr bool invertible = false;
+    static Value identity() {return std::numeric_limits<T>::max();};
+    static Value lift(const T& data) {return data;};
+    static Value combine(const Value& a, const Value& b) {return std::min(a,b);};
+};
+
+template <typename T>
+struct RingMax
+{
+    using Value = T;
+    static constexpr bool invertible = false;
+    static Value identity() {return std::numeric_limits<T>::lowest();};
+    static Value lift(const T& data) {return data;};
+    static Value combine(const Value& a, const Value& b) {return std::max(a,b);};
+};
+
+//ring, which keeps aggregate of all its elements
+//for invertible monoids every operation updates running aggregate in O(1)
+//other monoids use two stacks: pushFirst, pushLast and popFirst are O(1) amortised,
+//insert, erase and popLast in the middle of the ring make aggregate recalculated during next query
+template <typename Data, typename Monoid, typename Allocator = std::allocator<Data>>
+class AggregatedRing
+{
+public:
+    using RingType = Ring<Data,Allocator>;
+    using Iterator = typename RingType::Iterator;
+    using Value = typename Monoid::Value;
+private:
+    RingType ring;
+
+    //aggregate of all elements, used by invertible monoids
+    Value total;
+
+    //front stack holds the first elements of the ring
+    //front[i] is aggregate from the element on this level up to the last element of the stack
+    //so front.back() is aggregate of the whole front part
+    std::vector<Value> front;
+    //aggregate of elements after the front part
+    Value back;
+    //stacks do not describe the ring, they will be built again during next query
+    bool dirty;
+
+    //moves every element onto the front stack
+    void rebuild();
+
+    void added(const Data&);
+    void removed(const Data&);
+    //updates done before the first element is removed
+    void removedFirst(const Data&);
+public:
+    AggregatedRing() : total(Monoid::identity()), back(Monoid::identity()), dirty(false){};
+    explicit AggregatedRing(const Allocator& allocator) : ring(allocator), total(Monoid::identity()), back(Monoid::identity()), dirty(false){};
+
+    int getSize() const {return ring.getSize();};
+    bool isEmpty() const {return ring.isEmpty();};
+    const Data& getFirst() const {return ring.getFirst();};
+    const Data& getLast() const {return ring.getLast();};
+
+    //elements changed through iterators are not aggregated again
+    //they should be changed by erase and insert
+    Iterator begin() const {return ring.begin();};
+    Iterator end() const {return ring.end();};
+    const RingType& getRing() const {return ring;};
+
+    //sliding window, the oldest element leaves it when pushLast is done on full ring
+    void setCapacity(int capacity) {ring.setCapacity(capacity);};
+    int getCapacity() const {return ring.getCapacity();};
+
+    void pushFirst(const Data&);
+    void pushLast(const Data&);
+    void insert(Iterator, const Data&);
+
+    void popFirst();
+    void popLast();
+    void erase(Iterator);
+    void clear();
+
+    //aggregate of all elements in order from the first to the last
+    Value aggregate();
+};
+
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::rebuild()
+{
+    front.clear();
+    back = Monoid::identity();
+    dirty = false;
+
+    //stack is built from the last element, so the first element is on the top
+    Value accumulated = Monoid::identity();
+    for(auto it = ring.end(); it != ring.begin();)
+    {
+        --it;
+        accumulated = Monoid::combine(Monoid::lift(*it),accumulated);
+        front.push_back(accumulated);
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::added(const Data& data)
+{
+    if constexpr(Monoid::invertible)
+    {
+        total = Monoid::combine(total,Monoid::lift(data));
+    }
+    else
+    {
+        dirty = true;
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::removed(const Data& data)
+{
+    if constexpr(Monoid::invertible)
+    {
+        total = Monoid::combine(total,Monoid::inverse(Monoid::lift(data)));
+    }
+    else
+    {
+        dirty = true;
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::removedFirst(const Data& data)
+{
+    if constexpr(Monoid::invertible)
+    {
+        removed(data);
+    }
+    else
+    {
+        if(dirty)
+        {
+            return;
+        }
+        //every element is moved to the front stack, the first one is on the top
+        if(front.empty())
+        {
+            rebuild();
+        }
+        front.pop_back();
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::pushFirst(const Data& data)
+{
+    ring.pushFirst(data);
+
+    if constexpr(Monoid::invertible)
+    {
+        added(data);
+    }
+    else if(!dirty)
+    {
+        Value rest = front.empty() ? Monoid::identity() : front.back();
+        front.push_back(Monoid::combine(Monoid::lift(data),rest));
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::pushLast(const Data& data)
+{
+    //full ring overwrites the first element
+    if(ring.isFull())
+    {
+        removedFirst(ring.getFirst());
+    }
+    ring.pushLast(data);
+
+    if constexpr(Monoid::invertible)
+    {
+        added(data);
+    }
+    else if(!dirty)
+    {
+        back = Monoid::combine(back,Monoid::lift(data));
+    }
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::insert(Iterator place, const Data& data)
+{
+    ring.insert(place,data);
+    added(data);
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::popFirst()
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, element can't be removed.");
+    }
+    removedFirst(ring.getFirst());
+    ring.popFirst();
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::popLast()
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, element can't be removed.");
+    }
+    removed(ring.getLast());
+    ring.popLast();
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::erase(Iterator place)
+{
+    if(place == ring.end())
+    {
+        throw std::invalid_argument("End iterator can't be used.");
+    }
+    //erase throws for iterator of other ring, so aggregate is updated after it
+    Data value = *place;
+    ring.erase(place);
+    removed(value);
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+void AggregatedRing<Data,Monoid,Allocator>::clear()
+{
+    ring.clear();
+    total = Monoid::identity();
+    front.clear();
+    back = Monoid::identity();
+    dirty = false;
+}
+
+template <typename Data, typename Monoid, typename Allocator>
+typename AggregatedRing<Data,Monoid,Allocator>::Value AggregatedRing<Data,Monoid,Allocator>::aggregate()
+{
+    if constexpr(Monoid::invertible)
+    {
+        return total;
+    }
+    else
+    {
+        if(dirty)
+        {
+            rebuild();
+        }
+        Value first = front.empty() ? Monoid::identity() : front.back();
+        return Monoid::combine(first,back);
+    }
+}
+
+#endif
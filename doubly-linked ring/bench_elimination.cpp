@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "ring.hpp"
+
+//compares Eliminator with removing every k-th element by moving through the ring
+//usage: bench_elimination [n] [k], by default n = 10000000 and k = 100
+
+using Clock = std::chrono::steady_clock;
+
+void createRing(Ring<int>& ring, int n)
+{
+    for(int i = 1; i <= n; ++i)
+    {
+        ring.pushLast(i);
+    }
+}
+
+double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    int k = argc > 2 ? std::atoi(argv[2]) : 100;
+    if(n <= 0 || k <= 0)
+    {
+        std::cerr << "n and k have to be positive" << std::endl;
+        return 1;
+    }
+
+    //naive loop, every removal costs O(k) steps
+    Ring<int> naive;
+    createRing(naive,n);
+    Clock::time_point start = Clock::now();
+    long long checksum1 = 0;
+    while(!naive.isEmpty())
+    {
+        //the first element is counted as the first one, so k - 1 steps are needed
+        naive.rotate((k - 1) % naive.getSize());
+        checksum1 = checksum1 * 31 + naive.getFirst();
+        naive.popFirst();
+    }
+    double naiveTime = seconds(start);
+
+    //Fenwick tree, every removal costs O(log n)
+    Ring<int> indexed;
+    createRing(indexed,n);
+    start = Clock::now();
+    Eliminator<int,std::allocator<int>,CheckedRing> eliminator(indexed,k);
+    long long checksum2 = 0;
+    while(eliminator.getRemaining() > 0)
+    {
+        checksum2 = checksum2 * 31 + eliminator.eliminate();
+    }
+    double eliminatorTime = seconds(start);
+
+    std::cout << "n = " << n << ", k = " << k << std::endl;
+    std::cout << "naive loop: " << naiveTime << " s" << std::endl;
+    std::cout << "eliminator: " << eliminatorTime << " s" << std::endl;
+    if(checksum1 != checksum2)
+    {
+        std::cerr << "results differ" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+//pool of blocks with equal size
+//memory is taken in big slabs, so blocks allocated one after another lie close to each other
+//freed blocks are kept on free list and reused before next slab is touched
+class SlabPool
+{
+private:
+    //freed block keeps pointer to the next freed block
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    std::size_t blockSize;
+    std::size_t alignment;
+    std::size_t blocksPerSlab;
+
+    std::vector<void*> slabs;
+    //index of the next slab, which will be used when current one is full
+    std::size_t nextSlab;
+    //free part of current slab
+    char* cursor;
+    char* slabEnd;
+
+    FreeBlock* freeList;
+    //number of blocks given to the user and not returned yet
+    std::size_t live;
+
+    //when every block is returned, slabs are used again from the beginning
+    //blocks allocated later are placed next to each other instead of in holes from free list
+    void reset();
+public:
+    SlabPool(std::size_t size, std::size_t align, std::size_t perSlab = 1024);
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+    ~SlabPool();
+
+    void* allocate();
+    //block is taken from free space of slabs, free list is skipped
+    //blocks taken this way one after another lie next to each other, even if there are holes from freed blocks
+    void* allocateFresh();
+    void deallocate(void*);
+
+    //every block need to be able to store FreeBlock and keep alignment of the next block
+    static std::size_t alignmentFor(std::size_t align) {return align < alignof(FreeBlock) ? alignof(FreeBlock) : align;};
+    static std::size_t blockSizeFor(std::size_t size, std::size_t align);
+
+    std::size_t getBlockSize() const {return blockSize;};
+    std::size_t getAlignment() const {return alignment;};
+    std::size_t getLiveCount() const {return live;};
+    std::size_t getSlabCount() const {return slabs.size();};
+};
+
+//pools shared by all copies of one PoolAllocator
+//every size of allocated type gets its own pool
+class SlabPoolSet
+{
+private:
+    std::vector<std::unique_ptr<SlabPool>> pools;
+    std::size_t blocksPerSlab;
+public:
+    explicit SlabPoolSet(std::size_t perSlab = 1024) : blocksPerSlab(perSlab){};
+
+    SlabPool& getPool(std::size_t size, std::size_t align);
+};
+
+//allocator, which takes single objects from SlabPool
+//copies and rebound copies share pools, so containers using them can exchange nodes
+template <typename T>
+class PoolAllocator
+{
+private:
+    std::shared_ptr<SlabPoolSet> pools;
+    //pool for objects of type T, found once during construction
+    SlabPool* pool;
+
+    template <typename U>
+    friend class PoolAllocator;
+public:
+    using value_type = T;
+
+    PoolAllocator() : PoolAllocator(std::make_shared<SlabPoolSet>()){};
+    explicit PoolAllocator(std::shared_ptr<SlabPoolSet> set) : pools(set), pool(&set->getPool(sizeof(T),alignof(T))){};
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : PoolAllocator(other.pools){};
+    //moved allocator has to stay usable, so it is only copied
+    PoolAllocator(const PoolAllocator&) = default;
+    PoolAllocator& operator=(const PoolAllocator&) = default;
+
+    T* allocate(std::size_t n);
+    //single object placed after the previously allocated ones, see SlabPool::allocateFresh
+    T* allocateFresh() {return static_cast<T*>(pool->allocateFresh());};
+    void deallocate(T* p, std::size_t n);
+
+    const SlabPool& getPool() const {return *pool;};
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const {return pools == other.pools;};
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const {return pools != other.pools;};
+};
+
+
+//-----------------SLAB POOL---------------
+inline SlabPool::SlabPool(std::size_t size, std::size_t align, std::size_t perSlab) :
+blockSize(blockSizeFor(size,align)), alignment(alignmentFor(align)), blocksPerSlab(perSlab), nextSlab(0),
+cursor(nullptr), slabEnd(nullptr), freeList(nullptr), live(0){}
+
+inline std::size_t SlabPool::blockSizeFor(std::size_t size, std::size_t align)
+{
+    align = alignmentFor(align);
+    if(size < sizeof(FreeBlock))
+    {
+        size = sizeof(FreeBlock);
+    }
+    return (size + align - 1) / align * align;
+}
+
+inline SlabPool::~SlabPool()
+{
+    for(void* slab : slabs)
+    {
+        ::operator delete(slab,std::align_val_t(alignment));
+    }
+}
+
+inline void* SlabPool::allocate()
+{
+    if(freeList == nullptr)
+    {
+        return allocateFresh();
+    }
+
+    void* result = freeList;
+    freeList = freeList->next;
+    ++live;
+    return result;
+}
+
+inline void* SlabPool::allocateFresh()
+{
+    if(cursor == slabEnd)
+    {
+        //slabs kept after reset are used before new one is allocated
+        if(nextSlab == slabs.size())
+        {
+            slabs.push_back(::operator new(blockSize * blocksPerSlab,std::align_val_t(alignment)));
+        }
+        cursor = static_cast<char*>(slabs[nextSlab]);
+        slabEnd = cursor + blockSize * blocksPerSlab;
+        ++nextSlab;
+    }
+    void* result = cursor;
+    cursor += blockSize;
+
+    ++live;
+    return result;
+}
+
+inline void SlabPool::deallocate(void* block)
+{
+    FreeBlock* freed = ::new(block) FreeBlock;
+    freed->next = freeList;
+    freeList = freed;
+
+    --live;
+    if(live == 0)
+    {
+        reset();
+    }
+}
+
+inline void SlabPool::reset()
+{
+    freeList = nullptr;
+    nextSlab = 0;
+    cursor = slabEnd = nullptr;
+}
+
+//-----------------SLAB POOL SET---------------
+inline SlabPool& SlabPoolSet::getPool(std::size_t size, std::size_t align)
+{
+    for(auto& pool : pools)
+    {
+        if(pool->getBlockSize() == SlabPool::blockSizeFor(size,align) && pool->getAlignment() == SlabPool::alignmentFor(align))
+        {
+            return *pool;
+        }
+    }
+
+    pools.push_back(std::unique_ptr<SlabPool>(new SlabPool(size,align,blocksPerSlab)));
+    return *pools.back();
+}
+
+//-----------------POOL ALLOCATOR---------------
+template <typename T>
+T* PoolAllocator<T>::allocate(std::size_t n)
+{
+    //only single objects are taken from the pool
+    if(n == 1)
+    {
+        return static_cast<T*>(pool->allocate());
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T),std::align_val_t(alignof(T))));
+}
+
+template <typename T>
+void PoolAllocator<T>::deallocate(T* p, std::size_t n)
+{
+    if(n == 1)
+    {
+        pool->deallocate(p);
+    }
+    else
+    {
+        ::operator delete(p,std::align_val_t(alignof(T)));
+    }
+}
+
+#endif
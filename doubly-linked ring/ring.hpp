@@ -1,8 +1,88 @@
 #ifndef RING_HPP
 #define RING_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
-template <typename Data>
+//policies deciding how ring and its iterators validate their use
+//checked ring throws an exception on every invalid operation
+struct CheckedRing
+{
+    static constexpr bool checked = true;
+};
+//unchecked ring only asserts, so validation disappears in builds with NDEBUG
+//iterator steps become simple pointer moves
+struct UncheckedRing
+{
+    static constexpr bool checked = false;
+};
+
+//header of a ring saved by Ring::save
+//elements follow it from the first to the last
+struct RingFileHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    //sizeof(Data) for raw elements, 0 otherwise
+    std::uint32_t elementSize;
+    std::uint32_t flags;
+    std::uint64_t count;
+    std::uint64_t reserved;
+
+    static constexpr std::uint32_t currentVersion = 1;
+    //elements are stored as raw bytes, so file can be mapped into memory
+    static constexpr std::uint32_t rawElements = 1;
+
+    bool isValid() const {return std::memcmp(magic,"RING",4) == 0 && version == currentVersion;};
+};
+static_assert(sizeof(RingFileHeader) == 32, "Header of saved ring has to take 32 bytes.");
+
+//elements, which are not trivially copyable, are saved by these functions
+//overloads for other types are found by argument-dependent lookup
+inline void writeRingElement(std::ostream& out, const std::string& data)
+{
+    std::uint64_t length = data.size();
+    out.write(reinterpret_cast<const char*>(&length),sizeof(length));
+    out.write(data.data(),static_cast<std::streamsize>(length));
+}
+
+inline void readRingElement(std::istream& in, std::string& data)
+{
+    std::uint64_t length = 0;
+    in.read(reinterpret_cast<char*>(&length),sizeof(length));
+    if(!in)
+    {
+        return;
+    }
+    data.resize(length);
+    in.read(data.data(),static_cast<std::streamsize>(length));
+}
+
+template <typename Data, typename Allocator, typename Checking>
+class SplitView;
+template <typename Data, typename Allocator, typename Checking>
+class Eliminator;
+
+//nodes are allocated by Allocator rebound to the node type
+//PoolAllocator from pool_allocator.hpp keeps them in slabs and reuses erased ones
+template <typename Data, typename Allocator = std::allocator<Data>, typename Checking = CheckedRing>
 class Ring 
 {
 private:
@@ -12,8 +92,60 @@ private:
         Data data;
         Node* next;
         Node* previous;
-        Node(Data d,Node* n = nullptr,Node* p = nullptr) : 
-        data(d), next(n), previous(p){};
+        //data is constructed in place from given arguments
+        template <typename... Args>
+        Node(Args&&... args) : data(std::forward<Args>(args)...), next(nullptr), previous(nullptr){};
+    };
+
+    //optional index used by isInside and count
+    //it is hidden behind abstract class, so Data has to be hashable only if index is enabled
+    struct MembershipIndex
+    {
+        virtual ~MembershipIndex(){};
+        virtual void add(const Data&) = 0;
+        virtual void remove(const Data&) = 0;
+        virtual int count(const Data&) const = 0;
+        virtual void clear() = 0;
+        //creates empty index of the same kind, used in copy constructor
+        virtual MembershipIndex* cloneEmpty() const = 0;
+    };
+
+    //type of key returned by key extractor
+    template <typename KeyOf>
+    using IndexKey = typename std::decay<decltype(std::declval<KeyOf>()(std::declval<const Data&>()))>::type;
+
+    //counts elements by key, key is extracted from Data by KeyOf
+    template <typename KeyOf, typename Hash>
+    struct HashIndex : public MembershipIndex
+    {
+        using Key = IndexKey<KeyOf>;
+
+        KeyOf keyOf;
+        std::unordered_map<Key,int,Hash> counts;
+
+        HashIndex(KeyOf k, Hash h) : keyOf(k), counts(0,h){};
+        void add(const Data& data) override {++counts[keyOf(data)];};
+        void remove(const Data& data) override
+        {
+            auto it = counts.find(keyOf(data));
+            if(it != counts.end() && --(it->second) == 0)
+            {
+                counts.erase(it);
+            }
+        };
+        int count(const Data& data) const override
+        {
+            auto it = counts.find(keyOf(data));
+            return it == counts.end() ? 0 : it->second;
+        };
+        void clear() override {counts.clear();};
+        MembershipIndex* cloneEmpty() const override {return new HashIndex(keyOf,counts.hash_function());};
+    };
+
+    //key extractor used by default, the whole element is a key
+    struct WholeElement
+    {
+        const Data& operator()(const Data& data) const {return data;};
     };
 public:
 class Iterator
@@ -21,19 +153,19 @@ class Iterator
     protected:
         //the ring to which iterator belongs
         //used in check if iterator belongs to ring, whose method is involved
-        const Ring<Data>* ring;
+        const Ring<Data,Allocator,Checking>* ring;
         Node* current;
         //first node pointed by iterator
         //if iterator do a full cicrcle and points first element, it becomes end iterator
         Node* first;
         //private constructor, inaccessible for user
         //makes things faster inside methods
-        Iterator(const Ring<Data>* r,Node* frs,Node* curr) : ring(r),current(curr), first(frs){};
+        Iterator(const Ring<Data,Allocator,Checking>* r,Node* frs,Node* curr) : ring(r),current(curr), first(frs){};
         //check if iterator can be decremented or incremented
-        //if not throws and exception
+        //if not throws and exception(or asserts in unchecked ring)
         void isValidToMove(bool forward);
         //check if iterator can be dereferenced
-        //if not throws an exception
+        //if not throws an exception(or asserts in unchecked ring)
         void isValidToAcces();
     public:
         bool isEnd(){return ring != nullptr && current == nullptr;};
@@ -61,13 +193,57 @@ class Iterator
         Iterator& operator=(const Iterator&);
 
         friend class Ring;
+        friend class Eliminator<Data,Allocator,Checking>;
     };
 private:
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    NodeAllocator nodeAllocator;
     Node* any;
     int size;
+    //nullptr if index is disabled
+    MembershipIndex* index;
+    //members of the node pointing to the next and to the previous element in the order visible to the user
+    //if ring is reversed, next element is pointed by previous pointer and vice versa
+    //thanks to that reverse only swaps them and does not need to touch any node
+    Node* Node::* nextLink;
+    Node* Node::* previousLink;
+    //maximal number of elements, 0 if ring is unbounded
+    int capacity;
+    //memory of nodes reserved by bounded ring, nodes on this list are not constructed
+    Node* spare;
+    int spareCount;
+
+    //neighbours of the node in the order visible to the user
+    //orientation is kept in the links, so a step is a single load without checking it
+    Node*& nextOf(Node* node) const {return node->*nextLink;};
+    Node*& previousOf(Node* node) const {return node->*previousLink;};
+    bool isReversed() const {return nextLink == &Node::previous;};
+
+    //every node is created and destroyed by these functions
+    template <typename... Args>
+    Node* createNode(Args&&...);
+    void destroyNode(Node*);
+    //frees memory reserved for nodes of bounded ring
+    void releaseSpare();
+    //frees spare nodes, which are not needed to keep size + spareCount equal to capacity
+    void trimSpare();
+    //throws if bounded ring can't take given number of new elements
+    void isValidToGrow(int added) const;
+
+    //links node before given one, in empty ring node becomes any
+    //node placed before any becomes the last element
+    void linkBefore(Node* place, Node* node);
+
+    //appends new node after the last one, keeps ring closed after every step
+    //used in bulk operations, where building iterators for every element is too slow
+    template <typename... Args>
+    void appendNode(Args&&...);
 public:
     int getSize()const {return size;};
     bool isEmpty() const {return size == 0;};
+    Allocator getAllocator() const {return Allocator(nodeAllocator);};
 
 
     Iterator begin();
@@ -81,33 +257,111 @@ public:
  
 
     //insert element before given iterator
-    void insert(Iterator,Data);
+    void insert(Iterator place, const Data& data) {emplace(place,data);};
+    void insert(Iterator place, Data&& data) {emplace(place,std::move(data));};
     //if we push element as first it will become new any
-    void pushFirst(Data data) {insert(begin(),data); any = any->previous;};
-    void pushLast(Data data) {insert(end(),data);};
-    void copy(const Ring<Data>&);
+    void pushFirst(const Data& data) {emplaceFirst(data);};
+    void pushFirst(Data&& data) {emplaceFirst(std::move(data));};
+    void pushLast(const Data& data) {emplaceLast(data);};
+    void pushLast(Data&& data) {emplaceLast(std::move(data));};
+
+    //construct element in place from given arguments
+    //return iterator to the new element
+    template <typename... Args>
+    Iterator emplace(Iterator,Args&&...);
+    template <typename... Args>
+    void emplaceFirst(Args&&... args) {emplace(begin(),std::forward<Args>(args)...); any = previousOf(any);};
+    //if bounded ring is full, the first(the oldest) element is overwritten
+    //and the second one becomes the first
+    template <typename... Args>
+    void emplaceLast(Args&&...);
+
+    //insert elements from range [first, last) before given iterator
+    //nodes are built into a chain and linked into the ring at once
+    template <typename InputIt>
+    void insertRange(Iterator,InputIt first, InputIt last);
+
+    void copy(const Ring<Data,Allocator,Checking>&);
 
     //erase element pointed by iterator
     void erase(Iterator);
     void popFirst();
     void popLast();
     void clear();
+
+    //writes ring in binary format: RingFileHeader followed by elements from the first to the last
+    //trivially copyable elements are written in blocks as raw bytes,
+    //other ones by writeRingElement, which has to be overloaded for Data
+    void save(std::ostream&) const;
+    //replaces elements of the ring with ones saved by save
+    //other elements need readRingElement and default constructor
+    //if loading fails, ring is not changed
+    void load(std::istream&);
+
+    //moves begin by k elements forward(or backward if k is negative)
+    //goes in the shorter direction, nodes are not touched
+    void rotate(int k);
+    //reverses order of elements in O(1)
+    void reverse();
+    //links all elements of other ring before given iterator, other ring becomes empty
+    //O(1) if both rings have the same orientation and this ring is not indexed
+    //rings need to have equal allocators
+    void splice(Iterator,Ring<Data,Allocator,Checking>&&);
+
+    //bounded ring never has more than capacity elements
+    //memory for all nodes is reserved here, so inserting and erasing allocate nothing later
+    //pushLast on full ring overwrites the oldest element, other inserts throw std::length_error
+    //capacity 0 makes ring unbounded again
+    //copy and move, both constructors and assignments, give the ring capacity and index of the other ring
+    void setCapacity(int);
+    int getCapacity() const {return capacity;};
+    bool isFull() const {return capacity != 0 && size == capacity;};
     
     //check if element with given data belong to ring
+    //O(1) expected time if index is enabled, linear scan otherwise
     bool isInside(const Data&) const;
-	
+    //number of elements equal to given data
+    int count(const Data&) const;
+
+    //index makes isInside and count constant in expected time
+    //it is updated by every insert and erase
+    //elements modified through iterators are not reindexed, index has to be enabled again
+    //ring assigned from other ring is indexed only if the other one is, as capacity is taken from it
+    void enableIndex() {enableIndex(WholeElement(),std::hash<Data>());};
+    //elements are compared by key returned by keyOf
+    template <typename KeyOf>
+    void enableIndex(KeyOf keyOf);
+    template <typename KeyOf, typename Hash>
+    void enableIndex(KeyOf keyOf, Hash hash);
+    void disableIndex();
+    bool isIndexed() const {return index != nullptr;};
 
-    Ring() : any(nullptr),size(0){};
-    Ring(const Ring<Data>&);
+    Ring() : Ring(Allocator()){};
+    explicit Ring(const Allocator& allocator) : nodeAllocator(allocator),any(nullptr),size(0),index(nullptr),nextLink(&Node::next),
+    previousLink(&Node::previous),capacity(0),spare(nullptr),spareCount(0){};
+    Ring(const Ring<Data,Allocator,Checking>&);
+    //moved ring takes nodes of the other one, iterators of the other ring can't be used anymore
+    Ring(Ring<Data,Allocator,Checking>&&);
     ~Ring();
-    Ring<Data>& operator=(const Ring<Data>&);
+    Ring<Data,Allocator,Checking>& operator=(const Ring<Data,Allocator,Checking>&);
+    Ring<Data,Allocator,Checking>& operator=(Ring<Data,Allocator,Checking>&&);
+
+    //view walks over nodes directly
+    friend class SplitView<Data,Allocator,Checking>;
+    friend class Eliminator<Data,Allocator,Checking>;
 };
 
 
 //-----------------ITERATOR---------------
-template <typename Data>
-void Ring<Data>::Iterator::isValidToAcces()
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::Iterator::isValidToAcces()
 {
+    if constexpr(!Checking::checked)
+    {
+        assert(!isEmpty() && !isEnd());
+        return;
+    }
+
     if(isEmpty())
     {
         throw std::logic_error("Empty iterator can't be dereferenced.");
@@ -118,9 +372,15 @@ void Ring<Data>::Iterator::isValidToAcces()
     }
 }
 
-template <typename Data>
-void Ring<Data>::Iterator::isValidToMove(bool forward)
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::Iterator::isValidToMove(bool forward)
 {
+    if constexpr(!Checking::checked)
+    {
+        assert(!isEmpty() && (forward ? !isEnd() : !isBegin()));
+        return;
+    }
+
     if(isEmpty())
     {
         throw std::logic_error("Empty iterator can't be moved.");
@@ -145,25 +405,25 @@ void Ring<Data>::Iterator::isValidToMove(bool forward)
     
 }
 
-template <typename Data>
-bool Ring<Data>::Iterator::operator==(const Iterator& it) const
+template <typename Data, typename Allocator, typename Checking>
+bool Ring<Data,Allocator,Checking>::Iterator::operator==(const Iterator& it) const
 {
     return (ring == it.ring && current == it.current && first == it.first);
 }
 
 
-template <typename Data>
-bool Ring<Data>::Iterator::operator!=(const Iterator& it) const
+template <typename Data, typename Allocator, typename Checking>
+bool Ring<Data,Allocator,Checking>::Iterator::operator!=(const Iterator& it) const
 {
     return (ring != it.ring || first != it.first || current != it.current);
 }
 
 
-template <typename Data>
-typename Ring<Data>::Iterator& Ring<Data>::Iterator::operator++()//prefix
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator& Ring<Data,Allocator,Checking>::Iterator::operator++()//prefix
 {
     isValidToMove(true);
-    current = current->next;
+    current = ring->nextOf(current);
     //we did a full circle, hence iterator will become end iterator
     if(current == first)
     {
@@ -173,8 +433,8 @@ typename Ring<Data>::Iterator& Ring<Data>::Iterator::operator++()//prefix
     return *this;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::Iterator::operator++(int)//postfix
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::Iterator::operator++(int)//postfix
 {
     //do not need to check iterator
     //prefix ++ operator will do it
@@ -183,8 +443,8 @@ typename Ring<Data>::Iterator Ring<Data>::Iterator::operator++(int)//postfix
     return result;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::Iterator::operator+(int times) const
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::Iterator::operator+(int times) const
 {
     //do not need to check iterator
     //prefix ++ operator will do it
@@ -197,32 +457,32 @@ typename Ring<Data>::Iterator Ring<Data>::Iterator::operator+(int times) const
     return result;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator& Ring<Data>::Iterator::operator--()//prefix
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator& Ring<Data,Allocator,Checking>::Iterator::operator--()//prefix
 {
     isValidToMove(false);
     //end iterator can be decremented too
     if(isEnd())
     {
-        current = first->previous;
+        current = ring->previousOf(first);
     }
     else
     {
-        current = current->previous;
+        current = ring->previousOf(current);
     }
     return *this;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::Iterator::operator--(int)//postfix
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::Iterator::operator--(int)//postfix
 {
     Iterator result = *this;
     --(*this);
     return result;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::Iterator::operator-(int times) const
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::Iterator::operator-(int times) const
 {
     Iterator result = *this;
     for(;times > 0; --times)
@@ -232,22 +492,22 @@ typename Ring<Data>::Iterator Ring<Data>::Iterator::operator-(int times) const
     return result;
 }
 
-template <typename Data>
-Data& Ring<Data>::Iterator::operator*()
+template <typename Data, typename Allocator, typename Checking>
+Data& Ring<Data,Allocator,Checking>::Iterator::operator*()
 {
     isValidToAcces();
     return current->data;
 }
 
-template <typename Data>
-const Data& Ring<Data>::Iterator::operator*() const
+template <typename Data, typename Allocator, typename Checking>
+const Data& Ring<Data,Allocator,Checking>::Iterator::operator*() const
 {
     isValidToAcces();
     return current->data;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator& Ring<Data>::Iterator::operator=(const Iterator& it)
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator& Ring<Data,Allocator,Checking>::Iterator::operator=(const Iterator& it)
 {
     first = it.first;
     current = it.current;
@@ -256,52 +516,154 @@ typename Ring<Data>::Iterator& Ring<Data>::Iterator::operator=(const Iterator& i
 }
 //---------------RING------------------
 
-template <typename Data>
-Ring<Data>::Ring(const Ring<Data>& toCopy) : any(nullptr), size(0)
+template <typename Data, typename Allocator, typename Checking>
+Ring<Data,Allocator,Checking>::Ring(const Ring<Data,Allocator,Checking>& toCopy) :
+nodeAllocator(NodeTraits::select_on_container_copy_construction(toCopy.nodeAllocator)),
+any(nullptr), size(0), index(nullptr), nextLink(&Node::next), previousLink(&Node::previous), capacity(0), spare(nullptr), spareCount(0)
 {
+    //copy is indexed and bounded in the same way as original
+    if(toCopy.index != nullptr)
+    {
+        index = toCopy.index->cloneEmpty();
+    }
+    setCapacity(toCopy.capacity);
     copy(toCopy);
 }
 
-template <typename Data>
-Ring<Data>::~Ring()
+template <typename Data, typename Allocator, typename Checking>
+Ring<Data,Allocator,Checking>::Ring(Ring<Data,Allocator,Checking>&& toMove) :
+nodeAllocator(std::move(toMove.nodeAllocator)), any(toMove.any), size(toMove.size),
+index(toMove.index), nextLink(toMove.nextLink), previousLink(toMove.previousLink), capacity(toMove.capacity), spare(toMove.spare), spareCount(toMove.spareCount)
+{
+    toMove.any = nullptr;
+    toMove.size = 0;
+    toMove.index = nullptr;
+    toMove.nextLink = &Node::next;
+    toMove.previousLink = &Node::previous;
+    toMove.capacity = 0;
+    toMove.spare = nullptr;
+    toMove.spareCount = 0;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+Ring<Data,Allocator,Checking>::~Ring()
 {
     clear();
+    releaseSpare();
+    delete index;
 }
 
-template <typename Data>
-Ring<Data>& Ring<Data>::operator=(const Ring<Data>& toCopy)
+template <typename Data, typename Allocator, typename Checking>
+Ring<Data,Allocator,Checking>& Ring<Data,Allocator,Checking>::operator=(const Ring<Data,Allocator,Checking>& toCopy)
 {
-    //self-copy check inside copy function
+    if(this == &toCopy)
+    {
+        return *this;
+    }
+
+    //ring becomes indexed and bounded in the same way as toCopy, as copy constructor makes it
+    MembershipIndex* created = toCopy.index != nullptr ? toCopy.index->cloneEmpty() : nullptr;
+    clear();
+    delete index;
+    index = created;
+    if constexpr(NodeTraits::propagate_on_container_copy_assignment::value)
+    {
+        if(nodeAllocator != toCopy.nodeAllocator)
+        {
+            //nodes have to be freed by allocator, which created them
+            releaseSpare();
+            nodeAllocator = toCopy.nodeAllocator;
+        }
+    }
+    setCapacity(toCopy.capacity);
     copy(toCopy);
     return *this;
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::begin()
+template <typename Data, typename Allocator, typename Checking>
+Ring<Data,Allocator,Checking>& Ring<Data,Allocator,Checking>::operator=(Ring<Data,Allocator,Checking>&& toMove)
+{
+    if(this == &toMove)
+    {
+        return *this;
+    }
+    clear();
+
+    if(NodeTraits::propagate_on_container_move_assignment::value || nodeAllocator == toMove.nodeAllocator)
+    {
+        releaseSpare();
+        if constexpr(NodeTraits::propagate_on_container_move_assignment::value)
+        {
+            nodeAllocator = std::move(toMove.nodeAllocator);
+        }
+        //nodes can be taken over, because they will be freed by equal allocator
+        any = toMove.any;
+        size = toMove.size;
+        nextLink = toMove.nextLink;
+        previousLink = toMove.previousLink;
+        capacity = toMove.capacity;
+        spare = toMove.spare;
+        spareCount = toMove.spareCount;
+        //index of moved ring describes taken nodes
+        delete index;
+        index = toMove.index;
+        toMove.index = nullptr;
+        toMove.any = nullptr;
+        toMove.size = 0;
+        toMove.nextLink = &Node::next;
+        toMove.previousLink = &Node::previous;
+        toMove.capacity = 0;
+        toMove.spare = nullptr;
+        toMove.spareCount = 0;
+    }
+    else
+    {
+        //allocators differ, so every element has to be moved into a new node
+        //index counts keys, so index of toMove still describes moved elements
+        delete index;
+        index = nullptr;
+        setCapacity(0);
+        setCapacity(toMove.capacity);
+        Node* source = toMove.any;
+        for(int x = 0; x < toMove.size; ++x)
+        {
+            appendNode(std::move(source->data));
+            source = toMove.nextOf(source);
+        }
+        index = toMove.index;
+        toMove.index = nullptr;
+        toMove.clear();
+    }
+
+    return *this;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::begin()
 {
     return Iterator(this,any,any);
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::begin() const
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::begin() const
 {
     return Iterator(this,any,any);
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::end()
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::end()
 {
     return Iterator(this,any,nullptr);
 }
 
-template <typename Data>
-typename Ring<Data>::Iterator Ring<Data>::end() const
+template <typename Data, typename Allocator, typename Checking>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::end() const
 {
     return Iterator(this,any,nullptr);
 }
 
-template <typename Data>
-Data& Ring<Data>::getFirst()
+template <typename Data, typename Allocator, typename Checking>
+Data& Ring<Data,Allocator,Checking>::getFirst()
 {
     if(isEmpty())
     {
@@ -310,8 +672,8 @@ Data& Ring<Data>::getFirst()
     return *begin();
 }
 
-template <typename Data>
-const Data& Ring<Data>::getFirst() const
+template <typename Data, typename Allocator, typename Checking>
+const Data& Ring<Data,Allocator,Checking>::getFirst() const
 {
     if(isEmpty())
     {
@@ -320,8 +682,8 @@ const Data& Ring<Data>::getFirst() const
     return *begin();
 }
 
-template <typename Data>
-Data& Ring<Data>::getLast()
+template <typename Data, typename Allocator, typename Checking>
+Data& Ring<Data,Allocator,Checking>::getLast()
 {
     if(isEmpty())
     {
@@ -330,8 +692,8 @@ Data& Ring<Data>::getLast()
     return *(end()-1);
 }
 
-template <typename Data>
-const Data& Ring<Data>::getLast() const
+template <typename Data, typename Allocator, typename Checking>
+const Data& Ring<Data,Allocator,Checking>::getLast() const
 {
     if(isEmpty())
     {
@@ -340,187 +702,775 @@ const Data& Ring<Data>::getLast() const
     return *(end()-1);
 }
 
-template <typename Data>
-void Ring<Data>::copy(const Ring<Data>& toCopy)
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::copy(const Ring<Data,Allocator,Checking>& toCopy)
 {
     if(this == &toCopy)
     {
         return;
     }
+    if(capacity != 0 && toCopy.size > capacity)
+    {
+        throw std::length_error("Copied ring has more elements than capacity of the ring.");
+    }
     clear();
 
-    for(auto x = toCopy.begin(); x != toCopy.end(); x++)
+    //walking over raw nodes, every element is appended directly after the last one
+    Node* source = toCopy.any;
+    for(int x = 0; x < toCopy.size; ++x)
     {
-        insert(this->end(),(*x));
+        appendNode(source->data);
+        source = toCopy.nextOf(source);
     }
 }
 
-
-template <typename Data>
-void Ring<Data>::insert(Iterator place, Data data)
+template <typename Data, typename Allocator, typename Checking>
+template <typename... Args>
+typename Ring<Data,Allocator,Checking>::Node* Ring<Data,Allocator,Checking>::createNode(Args&&... args)
 {
-    if(place.ring != this)
+    Node* node;
+    if(spare != nullptr)
     {
-        throw std::invalid_argument("Other's ring iterator can't be used.");
+        //memory of spare node stores only pointer to the next spare node
+        node = spare;
+        spare = *std::launder(reinterpret_cast<Node**>(node));
+        --spareCount;
+    }
+    else
+    {
+        node = NodeTraits::allocate(nodeAllocator,1);
     }
 
-    if(size == 0)
+    try
     {
-        any = new Node(data);
-        any->next = any->previous = any;
-        ++size;
+        NodeTraits::construct(nodeAllocator,node,std::forward<Args>(args)...);
     }
-    else if(place == end())
+    catch(...)
     {
-        //placing before end is equivalent to placing before begin
-        insert(begin(),data);
+        if(capacity != 0)
+        {
+            ::new(static_cast<void*>(node)) Node*(spare);
+            spare = node;
+            ++spareCount;
+        }
+        else
+        {
+            NodeTraits::deallocate(nodeAllocator,node,1);
+        }
+        throw;
+    }
+    return node;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::destroyNode(Node* node)
+{
+    NodeTraits::destroy(nodeAllocator,node);
+
+    //bounded ring keeps memory of the node for the next insert
+    if(capacity != 0)
+    {
+        ::new(static_cast<void*>(node)) Node*(spare);
+        spare = node;
+        ++spareCount;
     }
     else
-    //somewhere in the middle
     {
-        Node* toInsert = new Node(data,place.current,place.current->previous);
-        place.current->previous->next = toInsert;
-        place.current->previous = toInsert;
-        ++size;
+        NodeTraits::deallocate(nodeAllocator,node,1);
     }
 }
 
-
-template <typename Data>
-void Ring<Data>::erase(Iterator place)
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::releaseSpare()
 {
-    if(place.ring != this)
+    while(spare != nullptr)
     {
-        throw std::invalid_argument("Other's ring iterator can't be used.");
+        Node* node = spare;
+        spare = *std::launder(reinterpret_cast<Node**>(node));
+        NodeTraits::deallocate(nodeAllocator,node,1);
     }
-    else if(place == end())
+    spareCount = 0;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::isValidToGrow(int added) const
+{
+    if(capacity != 0 && size + added > capacity)
     {
-        throw std::invalid_argument("End iterator can't be used.");
+        throw std::length_error("Ring is full.");
     }
+}
 
-    if(size == 1)
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::setCapacity(int newCapacity)
+{
+    if(newCapacity < 0)
     {
-        delete any;
-        any = any->previous = any->next = nullptr;
+        throw std::invalid_argument("Capacity can't be negative.");
     }
-    else
+    if(newCapacity != 0 && newCapacity < size)
     {
-        //any will be deleted, we need to change it
-        if(place == begin())
-            any = any->next;
+        throw std::invalid_argument("Capacity can't be smaller than size of the ring.");
+    }
 
-        place.current->previous->next = place.current->next;
-        place.current->next->previous = place.current->previous;
-        delete place.current;
+    capacity = newCapacity;
+    if(capacity == 0)
+    {
+        releaseSpare();
+        return;
     }
-    --size;
 
+    //memory for every missing node is reserved now
+    while(size + spareCount < capacity)
+    {
+        Node* node = NodeTraits::allocate(nodeAllocator,1);
+        ::new(static_cast<void*>(node)) Node*(spare);
+        spare = node;
+        ++spareCount;
+    }
+    //ring was shrunk, too many nodes are reserved
+    trimSpare();
 }
 
-template <typename Data>
-void Ring<Data>::popFirst()
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::trimSpare()
 {
-    if(isEmpty())
+    while(spare != nullptr && size + spareCount > capacity)
     {
-        throw std::logic_error("Ring is empty, element can't be removed.");
+        Node* node = spare;
+        spare = *std::launder(reinterpret_cast<Node**>(node));
+        NodeTraits::deallocate(nodeAllocator,node,1);
+        --spareCount;
     }
-    erase(begin());
 }
 
-template <typename Data>
-void Ring<Data>::popLast()
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::linkBefore(Node* place, Node* node)
 {
-    if(isEmpty())
+    if(any == nullptr)
     {
-        throw std::logic_error("Ring is empty, element can't be removed.");
+        any = node->next = node->previous = node;
+    }
+    else
+    {
+        nextOf(node) = place;
+        previousOf(node) = previousOf(place);
+        nextOf(previousOf(place)) = node;
+        previousOf(place) = node;
     }
-    erase(end() - 1);
 }
 
-template <typename Data>
-void Ring<Data>::clear()
+template <typename Data, typename Allocator, typename Checking>
+template <typename... Args>
+void Ring<Data,Allocator,Checking>::appendNode(Args&&... args)
 {
-    while(getSize() != 0)
+    //new node is placed between the last node and any
+    Node* toInsert = createNode(std::forward<Args>(args)...);
+    linkBefore(any,toInsert);
+    ++size;
+
+    if(index != nullptr)
     {
-        erase(begin());
+        index->add(toInsert->data);
     }
 }
 
-template <typename Data>
-bool Ring<Data>::isInside(const Data& data) const
+
+template <typename Data, typename Allocator, typename Checking>
+template <typename... Args>
+typename Ring<Data,Allocator,Checking>::Iterator Ring<Data,Allocator,Checking>::emplace(Iterator place, Args&&... args)
 {
-	for(auto x = begin(); x != end(); ++x)
-	{
-		if(*x == data)
-		{
-			return true;
-		}
-	}
-	
-	return false;
+    if constexpr(Checking::checked)
+    {
+        if(place.ring != this)
+        {
+            throw std::invalid_argument("Other's ring iterator can't be used.");
+        }
+    }
+    assert(place.ring == this);
+    isValidToGrow(1);
+
+    Node* toInsert = createNode(std::forward<Args>(args)...);
+    //placing before end is equivalent to placing before begin
+    linkBefore(place.current == nullptr ? any : place.current,toInsert);
+    ++size;
+
+    if(index != nullptr)
+    {
+        index->add(toInsert->data);
+    }
+    return Iterator(this,any,toInsert);
 }
 
-//function used in split
-//iterator can be infinitely moved without reaching end
-template <typename Data>
-void moveRingIterator(typename Ring<Data>::Iterator& it,const Ring<Data>& ring, bool direction)
+template <typename Data, typename Allocator, typename Checking>
+template <typename... Args>
+void Ring<Data,Allocator,Checking>::emplaceLast(Args&&... args)
 {
-    //move to next element
-    if(direction)
+    if(!isFull())
     {
-        //end iterator and last element iterator will change into begin
-        if(it == ring.end() || it == ring.end() - 1)
+        emplace(end(),std::forward<Args>(args)...);
+        return;
+    }
+
+    //the oldest element is replaced in place, no node is allocated
+    //new element is created first, so if it fails, neither the ring nor its index is changed
+    Data replacement(std::forward<Args>(args)...);
+    if(index != nullptr)
+    {
+        index->add(replacement);
+        index->remove(any->data);
+    }
+    any->data = std::move(replacement);
+    any = nextOf(any);
+}
+
+template <typename Data, typename Allocator, typename Checking>
+template <typename InputIt>
+void Ring<Data,Allocator,Checking>::insertRange(Iterator place, InputIt first, InputIt last)
+{
+    if constexpr(Checking::checked)
+    {
+        if(place.ring != this)
         {
-            it = ring.begin();
+            throw std::invalid_argument("Other's ring iterator can't be used.");
         }
-        else
+    }
+    assert(place.ring == this);
+
+    if(first == last)
+    {
+        return;
+    }
+
+    //new elements are linked into a chain, which is not connected with the ring yet
+    //if creating of some element fails, the ring stays unchanged
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    int added = 0;
+    try
+    {
+        for(; first != last; ++first)
         {
-            ++it;
+            isValidToGrow(added + 1);
+            Node* node = createNode(*first);
+            if(head == nullptr)
+            {
+                head = node;
+            }
+            else
+            {
+                nextOf(tail) = node;
+                previousOf(node) = tail;
+            }
+            tail = node;
+            ++added;
         }
     }
-    //move to previous element
-    else
+    catch(...)
     {
-        //first element will change into last
-        if(it == ring.begin())
+        while(head != nullptr)
         {
-            it = ring.end() - 1;
+            Node* next = head == tail ? nullptr : nextOf(head);
+            destroyNode(head);
+            head = next;
         }
-        else
+        throw;
+    }
+
+    if(any == nullptr)
+    {
+        any = head;
+        nextOf(tail) = head;
+        previousOf(head) = tail;
+    }
+    else
+    {
+        Node* after = place.current == nullptr ? any : place.current;
+        Node* before = previousOf(after);
+        nextOf(before) = head;
+        previousOf(head) = before;
+        nextOf(tail) = after;
+        previousOf(after) = tail;
+    }
+    size += added;
+
+    if(index != nullptr)
+    {
+        Node* node = head;
+        for(int x = 0; x < added; ++x, node = nextOf(node))
         {
-            --it;
+            index->add(node->data);
         }
     }
-}				
-
-//function used in split
-//insert element in proper position in order to keep given direction
-template <typename Data>
-void insertInDirection(Ring<Data>& ring, const Data& data, bool direction)
-{
-	if(direction)
-	{
-		ring.insert(ring.end(),data);
-	}
-	else
-	{
-		if(ring.isEmpty())
-		{
-			ring.insert(ring.begin(),data);
-		}
-		else
-		{
-			ring.insert(ring.begin()+1,data);
-		}
-	}
 }
 
 
-template <typename Data>
-std::pair<Ring<Data> , Ring<Data>> split(const Ring<Data> &source,int startIndex, int length, 
-										 bool direction,int step1, bool direction1, int step2, bool direction2)
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::erase(Iterator place)
 {
-    if(startIndex < 0)
+    if constexpr(Checking::checked)
+    {
+        if(place.ring != this)
+        {
+            throw std::invalid_argument("Other's ring iterator can't be used.");
+        }
+        else if(place == end())
+        {
+            throw std::invalid_argument("End iterator can't be used.");
+        }
+    }
+    assert(place.ring == this && place != end());
+
+    if(index != nullptr)
+    {
+        index->remove(place.current->data);
+    }
+
+    if(size == 1)
+    {
+        destroyNode(any);
+        any = nullptr;
+    }
+    else
+    {
+        //any will be deleted, we need to change it
+        if(place == begin())
+            any = nextOf(any);
+
+        place.current->previous->next = place.current->next;
+        place.current->next->previous = place.current->previous;
+        destroyNode(place.current);
+    }
+    --size;
+
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::popFirst()
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, element can't be removed.");
+    }
+    erase(begin());
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::popLast()
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, element can't be removed.");
+    }
+    erase(end() - 1);
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::save(std::ostream& out) const
+{
+    constexpr bool raw = std::is_trivially_copyable<Data>::value;
+
+    RingFileHeader header = {{'R','I','N','G'},RingFileHeader::currentVersion,raw ? static_cast<std::uint32_t>(sizeof(Data)) : 0,
+                             raw ? RingFileHeader::rawElements : 0,static_cast<std::uint64_t>(size),0};
+    out.write(reinterpret_cast<const char*>(&header),sizeof(header));
+
+    if constexpr(raw)
+    {
+        //elements are gathered into a buffer, so stream is called once for every block
+        constexpr int blockSize = 4096;
+        std::vector<Data> block;
+        block.reserve(std::min(size,blockSize));
+        Node* node = any;
+        for(int i = 0; i < size; ++i)
+        {
+            block.push_back(node->data);
+            node = nextOf(node);
+            if(static_cast<int>(block.size()) == blockSize || i == size - 1)
+            {
+                out.write(reinterpret_cast<const char*>(block.data()),static_cast<std::streamsize>(block.size() * sizeof(Data)));
+                block.clear();
+            }
+        }
+    }
+    else
+    {
+        Node* node = any;
+        for(int i = 0; i < size; ++i)
+        {
+            writeRingElement(out,node->data);
+            node = nextOf(node);
+        }
+    }
+
+    if(!out)
+    {
+        throw std::runtime_error("Ring can't be written to the stream.");
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::load(std::istream& in)
+{
+    constexpr bool raw = std::is_trivially_copyable<Data>::value;
+
+    RingFileHeader header;
+    in.read(reinterpret_cast<char*>(&header),sizeof(header));
+    if(!in || !header.isValid())
+    {
+        throw std::invalid_argument("Stream doesn't contain a saved ring.");
+    }
+    if(((header.flags & RingFileHeader::rawElements) != 0) != raw || (raw && header.elementSize != sizeof(Data)))
+    {
+        throw std::invalid_argument("Saved ring has different type of elements.");
+    }
+    if(header.count > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+    {
+        throw std::length_error("Saved ring is too big.");
+    }
+
+    int count = static_cast<int>(header.count);
+    if(capacity != 0 && count > capacity)
+    {
+        throw std::length_error("Ring is full.");
+    }
+
+    //elements are read into other ring, this one is replaced only if everything was read
+    //loaded ring is bounded and indexed in the same way, so move assignment keeps both
+    Ring<Data,Allocator,Checking> loaded(getAllocator());
+    if(index != nullptr)
+    {
+        loaded.index = index->cloneEmpty();
+    }
+    loaded.setCapacity(capacity);
+
+    if constexpr(raw)
+    {
+        //elements are read in blocks of raw bytes, nodes are appended without building iterators
+        //bytes of every element are copied into aligned storage, so Data doesn't need default constructor
+        constexpr int blockSize = 4096;
+        std::vector<std::byte> block(static_cast<std::size_t>(std::min(count,blockSize)) * sizeof(Data));
+        for(int done = 0; done < count;)
+        {
+            int toRead = std::min(count - done,blockSize);
+            in.read(reinterpret_cast<char*>(block.data()),static_cast<std::streamsize>(toRead * sizeof(Data)));
+            if(!in)
+            {
+                break;
+            }
+            for(int i = 0; i < toRead; ++i)
+            {
+                alignas(Data) std::byte element[sizeof(Data)];
+                std::memcpy(element,block.data() + i * sizeof(Data),sizeof(Data));
+                loaded.appendNode(*std::launder(reinterpret_cast<Data*>(element)));
+            }
+            done += toRead;
+        }
+    }
+    else
+    {
+        for(int i = 0; i < count && in; ++i)
+        {
+            Data data;
+            readRingElement(in,data);
+            if(in)
+            {
+                loaded.appendNode(std::move(data));
+            }
+        }
+    }
+
+    if(!in)
+    {
+        throw std::runtime_error("Saved ring is incomplete.");
+    }
+    //allocators are equal, so nodes are only taken over
+    *this = std::move(loaded);
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::clear()
+{
+    if(size == 0)
+    {
+        return;
+    }
+
+    //ring is broken once into a list, there is no need to rewire neighbours of every deleted node
+    any->previous->next = nullptr;
+    Node* toDelete = any;
+    while(toDelete != nullptr)
+    {
+        Node* next = toDelete->next;
+        destroyNode(toDelete);
+        toDelete = next;
+    }
+
+    any = nullptr;
+    size = 0;
+
+    if(index != nullptr)
+    {
+        index->clear();
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::rotate(int k)
+{
+    if(size == 0)
+    {
+        return;
+    }
+
+    k = k % size;
+    if(k < 0)
+    {
+        k += size;
+    }
+
+    //moving backward is shorter
+    if(k > size / 2)
+    {
+        for(k = size - k; k > 0; --k)
+        {
+            any = previousOf(any);
+        }
+    }
+    else
+    {
+        for(; k > 0; --k)
+        {
+            any = nextOf(any);
+        }
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::reverse()
+{
+    if(size == 0)
+    {
+        return;
+    }
+
+    //the last element becomes the first one
+    any = previousOf(any);
+    std::swap(nextLink,previousLink);
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::splice(Iterator place, Ring<Data,Allocator,Checking>&& other)
+{
+    if constexpr(Checking::checked)
+    {
+        if(place.ring != this)
+        {
+            throw std::invalid_argument("Other's ring iterator can't be used.");
+        }
+    }
+    assert(place.ring == this);
+    if(&other == this)
+    {
+        throw std::invalid_argument("Ring can't be spliced into itself.");
+    }
+    if(other.size == 0)
+    {
+        return;
+    }
+    if(nodeAllocator != other.nodeAllocator)
+    {
+        throw std::invalid_argument("Rings with different allocators can't be spliced.");
+    }
+    isValidToGrow(other.size);
+
+    //nodes of other ring need to point in the same direction as nodes of this ring
+    if(other.isReversed() != isReversed())
+    {
+        Node* node = other.any;
+        for(int x = 0; x < other.size; ++x)
+        {
+            std::swap(node->next,node->previous);
+            node = node->previous;
+        }
+        other.nextLink = nextLink;
+        other.previousLink = previousLink;
+    }
+
+    if(index != nullptr)
+    {
+        Node* node = other.any;
+        for(int x = 0; x < other.size; ++x, node = node->next)
+        {
+            index->add(node->data);
+        }
+    }
+    if(other.index != nullptr)
+    {
+        other.index->clear();
+    }
+
+    if(size == 0)
+    {
+        any = other.any;
+    }
+    else
+    {
+        //placing before end is equivalent to placing before begin
+        Node* after = place.current == nullptr ? any : place.current;
+        Node* before = previousOf(after);
+        Node* first = other.any;
+        Node* last = previousOf(first);
+
+        nextOf(before) = first;
+        previousOf(first) = before;
+        nextOf(last) = after;
+        previousOf(after) = last;
+    }
+
+    size += other.size;
+    other.any = nullptr;
+    other.size = 0;
+
+    //taken nodes will become spare after erasing, so reserved ones are not needed anymore
+    if(capacity != 0)
+    {
+        trimSpare();
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+bool Ring<Data,Allocator,Checking>::isInside(const Data& data) const
+{
+    if(index != nullptr)
+    {
+        return index->count(data) > 0;
+    }
+
+    //raw nodes are compared, iterators are not needed to visit every element
+    Node* node = any;
+    for(int x = 0; x < size; ++x, node = node->next)
+    {
+        if(node->data == data)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+int Ring<Data,Allocator,Checking>::count(const Data& data) const
+{
+    if(index != nullptr)
+    {
+        return index->count(data);
+    }
+
+    int result = 0;
+    Node* node = any;
+    for(int x = 0; x < size; ++x, node = node->next)
+    {
+        if(node->data == data)
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+template <typename KeyOf>
+void Ring<Data,Allocator,Checking>::enableIndex(KeyOf keyOf)
+{
+    enableIndex(keyOf,std::hash<IndexKey<KeyOf>>());
+}
+
+template <typename Data, typename Allocator, typename Checking>
+template <typename KeyOf, typename Hash>
+void Ring<Data,Allocator,Checking>::enableIndex(KeyOf keyOf, Hash hash)
+{
+    //new index replaces previous one
+    MembershipIndex* created = new HashIndex<KeyOf,Hash>(keyOf,hash);
+    delete index;
+    index = created;
+
+    Node* node = any;
+    for(int x = 0; x < size; ++x, node = node->next)
+    {
+        index->add(node->data);
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Ring<Data,Allocator,Checking>::disableIndex()
+{
+    delete index;
+    index = nullptr;
+}
+
+//function used in split
+//iterator can be infinitely moved without reaching end
+template <typename Data, typename Allocator, typename Checking>
+void moveRingIterator(typename Ring<Data,Allocator,Checking>::Iterator& it,const Ring<Data,Allocator,Checking>& ring, bool direction)
+{
+    //move to next element
+    if(direction)
+    {
+        //end iterator and last element iterator will change into begin
+        if(it == ring.end() || it == ring.end() - 1)
+        {
+            it = ring.begin();
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    //move to previous element
+    else
+    {
+        //first element will change into last
+        if(it == ring.begin())
+        {
+            it = ring.end() - 1;
+        }
+        else
+        {
+            --it;
+        }
+    }
+}				
+
+//function used in split
+//insert element in proper position in order to keep given direction
+template <typename Data, typename Allocator, typename Checking>
+void insertInDirection(Ring<Data,Allocator,Checking>& ring, const Data& data, bool direction)
+{
+	if(direction)
+	{
+		ring.insert(ring.end(),data);
+	}
+	else
+	{
+		if(ring.isEmpty())
+		{
+			ring.insert(ring.begin(),data);
+		}
+		else
+		{
+			ring.insert(ring.begin()+1,data);
+		}
+	}
+}
+
+
+template <typename Data, typename Allocator, typename Checking>
+std::pair<Ring<Data,Allocator,Checking>, Ring<Data,Allocator,Checking>> split(const Ring<Data,Allocator,Checking> &source,int startIndex, int length, 
+										 bool direction,int step1, bool direction1, int step2, bool direction2)
+{
+    if(startIndex < 0)
     {
         throw std::invalid_argument("Start index can't be negative.");
     }
@@ -528,7 +1478,7 @@ std::pair<Ring<Data> , Ring<Data>> split(const Ring<Data> &source,int startIndex
     {
         throw std::invalid_argument("Step can't be negative number.");
     }
-	std::pair<Ring<Data>, Ring<Data>> result;
+	std::pair<Ring<Data,Allocator,Checking>, Ring<Data,Allocator,Checking>> result;
 	if(source.isEmpty())
 	{
 		//two empty rings
@@ -538,7 +1488,7 @@ std::pair<Ring<Data> , Ring<Data>> split(const Ring<Data> &source,int startIndex
 	{
 		//if startIndex > size
 		startIndex = startIndex % source.getSize();
-		typename Ring<Data>::Iterator it = source.begin() + startIndex;
+		typename Ring<Data,Allocator,Checking>::Iterator it = source.begin() + startIndex;
 		
 		while(length > 0)
 		{
@@ -562,4 +1512,574 @@ std::pair<Ring<Data> , Ring<Data>> split(const Ring<Data> &source,int startIndex
 	return result;
 }
 
+//k-way split, every output ring has its own step and direction
+//source is visited in the same way as in split, the first step1 elements go to the first ring,
+//next step2 elements to the second one etc.
+//place of every element in output ring can be calculated, so the rings are filled in parallel
+//output rings use default constructed allocators
+template <typename Data, typename Allocator, typename Checking>
+std::vector<Ring<Data,Allocator,Checking>> split(const Ring<Data,Allocator,Checking>& source, int startIndex, int length,
+                                                 bool direction, const std::vector<std::pair<int,bool>>& steps)
+{
+    if(startIndex < 0)
+    {
+        throw std::invalid_argument("Start index can't be negative.");
+    }
+
+    //number of elements visited in one full round of steps
+    long long period = 0;
+    for(const auto& step : steps)
+    {
+        if(step.first < 0)
+        {
+            throw std::invalid_argument("Step can't be negative number.");
+        }
+        period += step.first;
+    }
+
+    std::vector<Ring<Data,Allocator,Checking>> result(steps.size());
+    if(source.isEmpty() || length <= 0)
+    {
+        return result;
+    }
+    if(period == 0)
+    {
+        throw std::invalid_argument("At least one step has to be positive.");
+    }
+
+    //elements of the source can be accessed by index
+    std::vector<const Data*> index;
+    index.reserve(source.getSize());
+    for(auto it = source.begin(); it != source.end(); ++it)
+    {
+        index.push_back(&(*it));
+    }
+
+    const long long size = source.getSize();
+    const long long start = startIndex % size;
+
+    //offset of the first element of every output in one round of steps
+    std::vector<long long> offsets(steps.size());
+    for(std::size_t x = 1; x < steps.size(); ++x)
+    {
+        offsets[x] = offsets[x - 1] + steps[x - 1].first;
+    }
+
+    auto fill = [&](std::size_t output)
+    {
+        const long long step = steps[output].first;
+        if(step == 0)
+        {
+            return;
+        }
+
+        //full rounds and the part of the last one
+        long long count = length / period * step + std::min(std::max(length % period - offsets[output],0LL),step);
+
+        //position in source of the element, which is x-th in output
+        auto sourceIndex = [&](long long x)
+        {
+            long long visited = x / step * period + offsets[output] + x % step;
+            return direction ? (start + visited) % size : ((start - visited) % size + size) % size;
+        };
+
+        Ring<Data,Allocator,Checking>& ring = result[output];
+        if(count > 0)
+        {
+            ring.emplaceLast(*index[sourceIndex(0)]);
+        }
+        //the same order as in insertInDirection
+        //if direction is false, the first element stays at the beginning and the rest is reversed
+        if(steps[output].second)
+        {
+            for(long long x = 1; x < count; ++x)
+            {
+                ring.emplaceLast(*index[sourceIndex(x)]);
+            }
+        }
+        else
+        {
+            for(long long x = count - 1; x > 0; --x)
+            {
+                ring.emplaceLast(*index[sourceIndex(x)]);
+            }
+        }
+    };
+
+    //small splits are not worth creating threads
+    std::size_t threads = std::min<std::size_t>(steps.size(),std::max(1u,std::thread::hardware_concurrency()));
+    if(threads < 2 || length < (1 << 15))
+    {
+        for(std::size_t x = 0; x < steps.size(); ++x)
+        {
+            fill(x);
+        }
+        return result;
+    }
+
+    //every thread fills every threads-th output
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for(std::size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+        {
+            try
+            {
+                for(std::size_t x = t; x < steps.size(); x += threads)
+                {
+                    fill(x);
+                }
+            }
+            catch(...)
+            {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+    for(auto& error : errors)
+    {
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return result;
+}
+
+//two rings, which would be returned by split, seen without copying any element
+//every half is iterated in the same order as the ring created by split
+//source ring can't be modified as long as the view is used
+template <typename Data, typename Allocator, typename Checking>
+class SplitView
+{
+public:
+    using RingType = Ring<Data,Allocator,Checking>;
+private:
+    using Node = typename RingType::Node;
+
+    const RingType* source;
+    long long start;
+    long long length;
+    bool direction;
+    //number of elements visited in one round of both steps
+    long long period;
+    int steps[2];
+    bool directions[2];
+
+    //x-th element of the output, counted in order of visiting the source
+    long long sourceIndex(int output, long long x) const;
+    //element of the output, which is on given position in the output ring
+    long long elementAt(int output, long long count, long long position) const;
+public:
+    class Half;
+
+    class Iterator
+    {
+    private:
+        const SplitView* view;
+        int output;
+        //number of elements in the half
+        long long count;
+        //number of elements of the half already visited
+        long long position;
+        Node* node;
+
+        Iterator(const SplitView* v, int o, long long c, long long p, Node* n) : view(v), output(o), count(c), position(p), node(n){};
+    public:
+        Iterator() : view(nullptr), output(0), count(0), position(0), node(nullptr){};
+
+        Iterator& operator++();
+        Iterator operator++(int);
+        const Data& operator*() const;
+        const Data* operator->() const {return &(**this);};
+
+        bool operator==(const Iterator& it) const {return view == it.view && output == it.output && position == it.position;};
+        bool operator!=(const Iterator& it) const {return !(*this == it);};
+
+        friend class Half;
+    };
+
+    //one of the output rings
+    class Half
+    {
+    private:
+        const SplitView* view;
+        //0 for the first ring, 1 for the second one
+        int output;
+        long long count;
+        //node with the first element of the half
+        Node* firstNode;
+
+        Half(const SplitView* v, int o);
+    public:
+        int getSize() const {return static_cast<int>(count);};
+        bool isEmpty() const {return count == 0;};
+        Iterator begin() const {return Iterator(view,output,count,0,firstNode);};
+        Iterator end() const {return Iterator(view,output,count,count,nullptr);};
+
+        friend class SplitView;
+    };
+
+    //the same parameters as in split
+    SplitView(const RingType& source, int startIndex, int length,
+              bool direction, int step1, bool direction1, int step2, bool direction2);
+
+    Half first() const {return Half(this,0);};
+    Half second() const {return Half(this,1);};
+};
+
+template <typename Data, typename Allocator, typename Checking>
+SplitView<Data,Allocator,Checking>::SplitView(const RingType& ring, int startIndex, int len,
+                                             bool dir, int step1, bool direction1, int step2, bool direction2) :
+source(&ring), start(0), length(len < 0 ? 0 : len), direction(dir), period(step1 + step2),
+steps{step1,step2}, directions{direction1,direction2}
+{
+    if(startIndex < 0)
+    {
+        throw std::invalid_argument("Start index can't be negative.");
+    }
+    if(step1 < 0 || step2 < 0)
+    {
+        throw std::invalid_argument("Step can't be negative number.");
+    }
+    if(period == 0 && length > 0 && !ring.isEmpty())
+    {
+        throw std::invalid_argument("At least one step has to be positive.");
+    }
+
+    if(ring.isEmpty())
+    {
+        length = 0;
+    }
+    else
+    {
+        start = startIndex % ring.getSize();
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+SplitView<Data,Allocator,Checking>::Half::Half(const SplitView* v, int o) : view(v), output(o), count(0), firstNode(nullptr)
+{
+    long long step = view->steps[output];
+    if(view->length == 0 || step == 0)
+    {
+        return;
+    }
+
+    //full rounds and the part of the last one
+    long long offset = output == 0 ? 0 : view->steps[0];
+    long long rest = view->length % view->period - offset;
+    count = view->length / view->period * step + std::min(std::max(rest,0LL),step);
+
+    if(count > 0)
+    {
+        //walking from the beginning of the source in the shorter direction
+        const RingType& ring = *view->source;
+        long long index = view->sourceIndex(output,0);
+        firstNode = ring.any;
+        if(index <= ring.size / 2)
+        {
+            for(; index > 0; --index)
+            {
+                firstNode = ring.nextOf(firstNode);
+            }
+        }
+        else
+        {
+            for(index = ring.size - index; index > 0; --index)
+            {
+                firstNode = ring.previousOf(firstNode);
+            }
+        }
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+long long SplitView<Data,Allocator,Checking>::sourceIndex(int output, long long x) const
+{
+    long long step = steps[output];
+    long long offset = output == 0 ? 0 : steps[0];
+    long long size = source->size;
+
+    long long visited = x / step * period + offset + x % step;
+    return direction ? (start + visited) % size : ((start - visited) % size + size) % size;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+long long SplitView<Data,Allocator,Checking>::elementAt(int output, long long count, long long position) const
+{
+    //if direction is false, the first element stays at the beginning and the rest is reversed
+    if(directions[output] || position == 0)
+    {
+        return position;
+    }
+    return count - position;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+typename SplitView<Data,Allocator,Checking>::Iterator& SplitView<Data,Allocator,Checking>::Iterator::operator++()
+{
+    if(view == nullptr || position == count)
+    {
+        throw std::logic_error("End iterator can't be incremented.");
+    }
+
+    ++position;
+    if(position == count)
+    {
+        node = nullptr;
+        return *this;
+    }
+
+    //distance between neighbouring elements of the half, measured forward in the source
+    const RingType& ring = *view->source;
+    long long size = ring.size;
+    long long from = view->sourceIndex(output,view->elementAt(output,count,position - 1));
+    long long to = view->sourceIndex(output,view->elementAt(output,count,position));
+    long long distance = ((to - from) % size + size) % size;
+
+    if(distance <= size / 2)
+    {
+        for(; distance > 0; --distance)
+        {
+            node = ring.nextOf(node);
+        }
+    }
+    else
+    {
+        for(distance = size - distance; distance > 0; --distance)
+        {
+            node = ring.previousOf(node);
+        }
+    }
+    return *this;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+typename SplitView<Data,Allocator,Checking>::Iterator SplitView<Data,Allocator,Checking>::Iterator::operator++(int)
+{
+    Iterator result = *this;
+    ++(*this);
+    return result;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+const Data& SplitView<Data,Allocator,Checking>::Iterator::operator*() const
+{
+    if(node == nullptr)
+    {
+        throw std::logic_error("End iterator can't be dereferenced.");
+    }
+    return node->data;
+}
+
+//removes every k-th element of the ring, round-robin, as in Josephus problem
+//counting starts from given element, which is counted as the first one,
+//and continues from the element placed after the removed one
+//nodes are indexed by Fenwick tree, so finding and removing the next victim is O(log n)
+//instead of O(k) iterator steps, building the eliminator is O(n)
+//ring can be changed only by the eliminator as long as it is used
+template <typename Data, typename Allocator, typename Checking>
+class Eliminator
+{
+public:
+    using RingType = Ring<Data,Allocator,Checking>;
+    using Iterator = typename RingType::Iterator;
+private:
+    using Node = typename RingType::Node;
+
+    RingType* ring;
+    int step;
+    //nodes in order of counting, removed ones are set to nullptr
+    std::vector<Node*> nodes;
+    //Fenwick tree over nodes, 1 for every element still in the ring
+    std::vector<int> tree;
+    //the highest power of two not greater than number of nodes
+    int highestBit;
+    //number of elements left
+    int remaining;
+    //rank among remaining elements of the element, from which counting starts
+    int current;
+
+    //throws if ring was changed not by the eliminator
+    void isValidToUse() const;
+    //position in nodes of the remaining element with given rank
+    int select(int rank) const;
+    //position in nodes of the next victim
+    int victim() const;
+    void remove(int position);
+public:
+    //counting starts from the first element of the ring
+    //if direction is false elements are counted backward
+    Eliminator(RingType& ring, int step, bool direction = true) : Eliminator(ring,ring.begin(),step,direction){};
+    Eliminator(RingType& ring, Iterator start, int step, bool direction = true);
+
+    int getRemaining() const {return remaining;};
+
+    //element, which will be removed next
+    const Data& peek() const;
+    //removes the next victim and returns its data
+    Data eliminate();
+    //removes victims as long as condition(ring) is false, returns their data in order of removal
+    template <typename Condition>
+    std::vector<Data> eliminateUntil(Condition condition);
+    //removes victims until given number of elements is left
+    std::vector<Data> eliminateUntil(int left) {return eliminateUntil([left](const RingType& r){return r.getSize() <= left;});};
+};
+
+template <typename Data, typename Allocator, typename Checking>
+Eliminator<Data,Allocator,Checking>::Eliminator(RingType& r, Iterator start, int k, bool direction) :
+ring(&r), step(k), highestBit(1), remaining(r.size), current(0)
+{
+    if(k <= 0)
+    {
+        throw std::invalid_argument("Step has to be positive.");
+    }
+    if(start.ring != ring)
+    {
+        throw std::invalid_argument("Other's ring iterator can't be used.");
+    }
+    if(start.isEnd() && !ring->isEmpty())
+    {
+        throw std::invalid_argument("End iterator can't be used.");
+    }
+
+    nodes.reserve(remaining);
+    Node* node = start.current;
+    for(int i = 0; i < remaining; ++i)
+    {
+        nodes.push_back(node);
+        node = direction ? ring->nextOf(node) : ring->previousOf(node);
+    }
+
+    //every node is present, tree is built bottom-up in O(n)
+    tree.assign(remaining + 1,1);
+    tree[0] = 0;
+    for(int i = 1; i <= remaining; ++i)
+    {
+        int parent = i + (i & -i);
+        if(parent <= remaining)
+        {
+            tree[parent] += tree[i];
+        }
+    }
+    while(highestBit * 2 <= remaining)
+    {
+        highestBit *= 2;
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Eliminator<Data,Allocator,Checking>::isValidToUse() const
+{
+    if constexpr(!Checking::checked)
+    {
+        assert(remaining > 0 && ring->size == remaining);
+        return;
+    }
+
+    if(ring->size != remaining)
+    {
+        throw std::logic_error("Ring was changed during elimination.");
+    }
+    if(remaining == 0)
+    {
+        throw std::logic_error("Ring is empty, element can't be removed.");
+    }
+}
+
+template <typename Data, typename Allocator, typename Checking>
+int Eliminator<Data,Allocator,Checking>::select(int rank) const
+{
+    //descends the tree, looking for the last prefix with at most rank elements
+    int position = 0;
+    for(int bit = highestBit; bit > 0; bit /= 2)
+    {
+        int next = position + bit;
+        if(next < static_cast<int>(tree.size()) && tree[next] <= rank)
+        {
+            position = next;
+            rank -= tree[next];
+        }
+    }
+    //tree is indexed from 1
+    return position;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+int Eliminator<Data,Allocator,Checking>::victim() const
+{
+    long long rank = (static_cast<long long>(current) + step - 1) % remaining;
+    return select(static_cast<int>(rank));
+}
+
+template <typename Data, typename Allocator, typename Checking>
+void Eliminator<Data,Allocator,Checking>::remove(int position)
+{
+    Node* node = nodes[position];
+    nodes[position] = nullptr;
+    for(int i = position + 1; i < static_cast<int>(tree.size()); i += i & -i)
+    {
+        --tree[i];
+    }
+
+    //rank of the victim is taken by the next element
+    current = static_cast<int>((static_cast<long long>(current) + step - 1) % remaining);
+    --remaining;
+    if(remaining > 0)
+    {
+        current %= remaining;
+    }
+    else
+    {
+        current = 0;
+    }
+    ring->erase(Iterator(ring,ring->any,node));
+}
+
+template <typename Data, typename Allocator, typename Checking>
+const Data& Eliminator<Data,Allocator,Checking>::peek() const
+{
+    isValidToUse();
+    return nodes[victim()]->data;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+Data Eliminator<Data,Allocator,Checking>::eliminate()
+{
+    isValidToUse();
+    int position = victim();
+    //indexed ring needs the data to remove it from the index
+    Data result = ring->index != nullptr ? Data(nodes[position]->data) : Data(std::move(nodes[position]->data));
+    remove(position);
+    return result;
+}
+
+template <typename Data, typename Allocator, typename Checking>
+template <typename Condition>
+std::vector<Data> Eliminator<Data,Allocator,Checking>::eliminateUntil(Condition condition)
+{
+    std::vector<Data> removed;
+    while(!condition(static_cast<const RingType&>(*ring)))
+    {
+        removed.push_back(eliminate());
+    }
+    return removed;
+}
+
+//ring, which takes memory from std::pmr::memory_resource
+//e.g. monotonic_buffer_resource can be used as an arena for short-lived rings
+template <typename Data>
+using PmrRing = Ring<Data,std::pmr::polymorphic_allocator<Data>>;
+
+//ring without validation of iterators, for hot loops
+template <typename Data>
+using FastRing = Ring<Data,std::allocator<Data>,UncheckedRing>;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#ifndef RING_MMAP_HPP
+#define RING_MMAP_HPP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "ring.hpp"
+
+//read-only ring saved by Ring::save and mapped into memory
+//no node is built, elements are read straight from the file
+//iterators behave like Ring::Iterator: incrementing the last element gives end,
+//end can be decremented to the last element, moveRingIterator goes around the ring
+//only rings of trivially copyable elements can be mapped
+template <typename Data>
+class MappedRing
+{
+    static_assert(std::is_trivially_copyable<Data>::value, "Only trivially copyable elements are saved as raw bytes.");
+    static_assert(alignof(Data) <= sizeof(RingFileHeader), "Elements placed after the header have to be aligned.");
+public:
+    class Iterator
+    {
+    private:
+        const MappedRing<Data>* ring;
+        //index of the element, size of the ring for end iterator
+        long long current;
+
+        Iterator(const MappedRing<Data>* r, long long curr) : ring(r), current(curr){};
+
+        void isValidToMove(bool forward) const;
+        void isValidToAcces() const;
+    public:
+        bool isEnd() const {return ring != nullptr && current == ring->size;};
+        bool isBegin() const {return ring != nullptr && current == 0;};
+        bool isEmpty() const {return ring == nullptr || ring->size == 0;};
+
+        Iterator() : ring(nullptr), current(0){};
+
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator operator+(int) const;
+
+        Iterator& operator--();
+        Iterator operator--(int);
+        Iterator operator-(int) const;
+
+        const Data& operator*() const;
+        const Data* operator->() const {return &(**this);};
+
+        bool operator==(const Iterator& it) const {return ring == it.ring && current == it.current;};
+        bool operator!=(const Iterator& it) const {return !(*this == it);};
+
+        friend class MappedRing;
+    };
+private:
+    void* mapping;
+    size_t mappingSize;
+    const Data* elements;
+    long long size;
+
+    void unmap();
+public:
+    //throws if file can't be opened or doesn't contain ring of Data
+    explicit MappedRing(const std::string& path);
+    MappedRing(const MappedRing<Data>&) = delete;
+    MappedRing<Data>& operator=(const MappedRing<Data>&) = delete;
+    ~MappedRing() {unmap();};
+
+    int getSize() const {return static_cast<int>(size);};
+    bool isEmpty() const {return size == 0;};
+
+    Iterator begin() const {return Iterator(this,0);};
+    Iterator end() const {return Iterator(this,size);};
+    const Data& getFirst() const;
+    const Data& getLast() const;
+};
+
+
+//-----------------ITERATOR---------------
+template <typename Data>
+void MappedRing<Data>::Iterator::isValidToAcces() const
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Empty iterator can't be dereferenced.");
+    }
+    if(isEnd())
+    {
+        throw std::logic_error("End iterator can't be dereferenced.");
+    }
+}
+
+template <typename Data>
+void MappedRing<Data>::Iterator::isValidToMove(bool forward) const
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Empty iterator can't be moved.");
+    }
+    if(forward && isEnd())
+    {
+        throw std::logic_error("End iterator can't be incremented.");
+    }
+    if(!forward && isBegin())
+    {
+        throw std::logic_error("Begin iterator can't be decremented.");
+    }
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator& MappedRing<Data>::Iterator::operator++()
+{
+    isValidToMove(true);
+    ++current;
+    return *this;
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator MappedRing<Data>::Iterator::operator++(int)
+{
+    Iterator result = *this;
+    ++(*this);
+    return result;
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator MappedRing<Data>::Iterator::operator+(int times) const
+{
+    Iterator result = *this;
+    if(times > 0)
+    {
+        //every step is valid only if the end is not passed
+        result.isValidToMove(true);
+        if(times > result.ring->size - result.current)
+        {
+            throw std::logic_error("End iterator can't be incremented.");
+        }
+        result.current += times;
+    }
+    return result;
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator& MappedRing<Data>::Iterator::operator--()
+{
+    isValidToMove(false);
+    --current;
+    return *this;
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator MappedRing<Data>::Iterator::operator--(int)
+{
+    Iterator result = *this;
+    --(*this);
+    return result;
+}
+
+template <typename Data>
+typename MappedRing<Data>::Iterator MappedRing<Data>::Iterator::operator-(int times) const
+{
+    Iterator result = *this;
+    if(times > 0)
+    {
+        result.isValidToMove(false);
+        if(times > result.current)
+        {
+            throw std::logic_error("Begin iterator can't be decremented.");
+        }
+        result.current -= times;
+    }
+    return result;
+}
+
+template <typename Data>
+const Data& MappedRing<Data>::Iterator::operator*() const
+{
+    isValidToAcces();
+    return ring->elements[current];
+}
+
+
+//-----------------MAPPED RING---------------
+template <typename Data>
+MappedRing<Data>::MappedRing(const std::string& path) : mapping(MAP_FAILED), mappingSize(0), elements(nullptr), size(0)
+{
+    int descriptor = open(path.c_str(),O_RDONLY);
+    if(descriptor == -1)
+    {
+        throw std::runtime_error("File " + path + " can't be opened.");
+    }
+
+    struct stat status;
+    if(fstat(descriptor,&status) == -1 || status.st_size < static_cast<off_t>(sizeof(RingFileHeader)))
+    {
+        close(descriptor);
+        throw std::invalid_argument("File " + path + " doesn't contain a saved ring.");
+    }
+
+    mappingSize = static_cast<size_t>(status.st_size);
+    mapping = mmap(nullptr,mappingSize,PROT_READ,MAP_PRIVATE,descriptor,0);
+    //mapping keeps its own reference to the file, so descriptor isn't needed anymore
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("File " + path + " can't be mapped.");
+    }
+
+    const RingFileHeader* header = static_cast<const RingFileHeader*>(mapping);
+    if(!header->isValid())
+    {
+        unmap();
+        throw std::invalid_argument("File " + path + " doesn't contain a saved ring.");
+    }
+    if((header->flags & RingFileHeader::rawElements) == 0 || header->elementSize != sizeof(Data))
+    {
+        unmap();
+        throw std::invalid_argument("Saved ring has different type of elements.");
+    }
+    if(header->count > (mappingSize - sizeof(RingFileHeader)) / sizeof(Data))
+    {
+        unmap();
+        throw std::invalid_argument("Saved ring is incomplete.");
+    }
+
+    size = static_cast<long long>(header->count);
+    elements = reinterpret_cast<const Data*>(static_cast<const char*>(mapping) + sizeof(RingFileHeader));
+    //elements are read in order, kernel can read ahead
+    madvise(mapping,mappingSize,MADV_SEQUENTIAL);
+}
+
+template <typename Data>
+void MappedRing<Data>::unmap()
+{
+    if(mapping != MAP_FAILED)
+    {
+        munmap(mapping,mappingSize);
+        mapping = MAP_FAILED;
+    }
+}
+
+template <typename Data>
+const Data& MappedRing<Data>::getFirst() const
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, there is no element to get.");
+    }
+    return elements[0];
+}
+
+template <typename Data>
+const Data& MappedRing<Data>::getLast() const
+{
+    if(isEmpty())
+    {
+        throw std::logic_error("Ring is empty, there is no element to get.");
+    }
+    return elements[size - 1];
+}
+
+//moves iterator to the next(or previous) element, the last element is followed by the first one
+template <typename Data>
+void moveRingIterator(typename MappedRing<Data>::Iterator& it, const MappedRing<Data>& ring, bool direction)
+{
+    if(direction)
+    {
+        if(it == ring.end() || it == ring.end() - 1)
+        {
+            it = ring.begin();
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    else
+    {
+        if(it == ring.begin())
+        {
+            it = ring.end() - 1;
+        }
+        else
+        {
+            --it;
+        }
+    }
+}
+
+#endif
@@ -1,7 +1,44 @@
 #include <catch2/catch_all.hpp>
 #include "ring.hpp"
+#include "pool_allocator.hpp"
+#include "aggregated_ring.hpp"
+#include "ring_mmap.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 
-void createRing(Ring<int>& ring, int size)
+//objects allocated by CountingAllocator of any type and not freed yet
+long long countedAllocations = 0;
+
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&){};
+
+    T* allocate(std::size_t n)
+    {
+        countedAllocations += static_cast<long long>(n);
+        return std::allocator<T>().allocate(n);
+    };
+    void deallocate(T* pointer, std::size_t n)
+    {
+        countedAllocations -= static_cast<long long>(n);
+        std::allocator<T>().deallocate(pointer,n);
+    };
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const {return true;};
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const {return false;};
+};
+
+template <typename Allocator, typename Checking>
+void createRing(Ring<int,Allocator,Checking>& ring, int size)
 {
     for(int x = 0; x < size; ++x)
     {
@@ -180,14 +217,956 @@ TEST_CASE("Split")
     CHECK(*(result.second.end()-1) == 7);
 }
 
+TEST_CASE("Clearing and copying big rings")
+{
+    Ring<int> ring1;
+    createRing(ring1,10000);
+
+    Ring<int> ring2(ring1);
+    CHECK(ring2.getSize() == 10000);
+    CHECK(ring2.getFirst() == 1);
+    CHECK(ring2.getLast() == 10000);
+    //ring is closed after copy
+    CHECK(*(ring2.end() - 1) == 10000);
+    CHECK(*(ring2.begin() + 9999) == 10000);
+
+    ring1.clear();
+    CHECK(ring1.isEmpty());
+    //ring can be used after clear
+    ring1.pushLast(5);
+    ring1.pushFirst(4);
+    CHECK(ring1.getSize() == 2);
+    CHECK(ring1.getFirst() == 4);
+    CHECK(ring1.getLast() == 5);
+
+    //copy over not empty ring
+    ring2 = ring1;
+    CHECK(ring2.getSize() == 2);
+    CHECK(ring2.getFirst() == 4);
+    CHECK(*(ring2.begin() + 1) == 5);
+
+    //copy of empty ring
+    Ring<int> empty;
+    ring2 = empty;
+    CHECK(ring2.isEmpty());
+}
+
+TEST_CASE("Membership index")
+{
+    Ring<int> ring;
+    createRing(ring,5);
+    ring.pushLast(3);
+
+    //without index
+    CHECK(ring.isIndexed() == false);
+    CHECK(ring.count(3) == 2);
+    CHECK(ring.count(7) == 0);
+
+    ring.enableIndex();
+    CHECK(ring.isIndexed());
+    CHECK(ring.count(3) == 2);
+    CHECK(ring.isInside(5));
+    CHECK(ring.isInside(7) == false);
+
+    //index follows insert and erase
+    ring.insert(ring.begin() + 1,7);
+    CHECK(ring.isInside(7));
+    ring.erase(ring.begin() + 1);
+    CHECK(ring.isInside(7) == false);
+    ring.popLast();
+    CHECK(ring.count(3) == 1);
+    ring.popFirst();
+    CHECK(ring.isInside(1) == false);
+
+    //copy is indexed too
+    Ring<int> copied(ring);
+    CHECK(copied.isIndexed());
+    CHECK(copied.count(3) == 1);
+
+    ring.clear();
+    CHECK(ring.isInside(3) == false);
+    ring.pushFirst(3);
+    CHECK(ring.count(3) == 1);
+
+    ring.disableIndex();
+    CHECK(ring.isIndexed() == false);
+    CHECK(ring.isInside(3));
+
+    //elements compared by key
+    Ring<std::pair<int,char>> pairs;
+    pairs.pushLast(std::make_pair(1,'a'));
+    pairs.pushLast(std::make_pair(2,'b'));
+    pairs.enableIndex([](const std::pair<int,char>& p){return p.first;});
+    CHECK(pairs.isInside(std::make_pair(1,'z')));
+    CHECK(pairs.count(std::make_pair(3,'a')) == 0);
+}
+
+TEST_CASE("Rotate, reverse and splice")
+{
+    Ring<int> ring;
+    createRing(ring,5);
+
+    //rotate
+    ring.rotate(2);
+    CHECK(ring.getFirst() == 3);
+    CHECK(ring.getLast() == 2);
+    ring.rotate(-3);
+    CHECK(ring.getFirst() == 5);
+    ring.rotate(4);
+    CHECK(ring.getFirst() == 4);
+    ring.rotate(11);
+    CHECK(ring.getFirst() == 5);
+    ring.rotate(1);
+    CHECK(ring.getFirst() == 1);
+
+    //reverse
+    ring.reverse();
+    for(int x = 0; x < 5; ++x)
+    {
+        CHECK(*(ring.begin() + x) == 5 - x);
+    }
+    CHECK(*(ring.end() - 1) == 1);
+
+    //inserting and erasing in reversed ring
+    ring.pushLast(0);
+    ring.pushFirst(6);
+    ring.insert(ring.begin() + 2,10);
+    //{6,5,10,4,3,2,1,0}
+    CHECK(ring.getSize() == 8);
+    CHECK(*(ring.begin() + 2) == 10);
+    CHECK(*(ring.begin() + 3) == 4);
+    ring.erase(ring.begin() + 2);
+    ring.popFirst();
+    ring.popLast();
+    CHECK(ring.getFirst() == 5);
+    CHECK(ring.getLast() == 1);
+
+    //copy of reversed ring keeps the order
+    Ring<int> copied(ring);
+    for(int x = 0; x < 5; ++x)
+    {
+        CHECK(*(copied.begin() + x) == 5 - x);
+    }
+
+    //reversing again gives the original order
+    ring.reverse();
+    for(int x = 0; x < 5; ++x)
+    {
+        CHECK(*(ring.begin() + x) == x + 1);
+    }
+
+    //splice in the middle
+    Ring<int> other;
+    createRing(other,3);
+    ring.splice(ring.begin() + 1,std::move(other));
+    //{1,1,2,3,2,3,4,5}
+    CHECK(other.isEmpty());
+    CHECK(ring.getSize() == 8);
+    CHECK(*(ring.begin() + 1) == 1);
+    CHECK(*(ring.begin() + 3) == 3);
+    CHECK(*(ring.begin() + 4) == 2);
+
+    //splice at the end of ring with different orientation
+    createRing(other,2);
+    other.reverse();
+    ring.splice(ring.end(),std::move(other));
+    CHECK(ring.getSize() == 10);
+    CHECK(*(ring.end() - 2) == 2);
+    CHECK(ring.getLast() == 1);
+    CHECK(*(ring.begin() + 9) == 1);
+    CHECK(*(ring.end() - 10) == 1);
+
+    //splice into empty ring
+    Ring<int> empty;
+    empty.splice(empty.begin(),std::move(copied));
+    CHECK(empty.getSize() == 5);
+    CHECK(empty.getFirst() == 5);
+    CHECK(copied.isEmpty());
+
+    CHECK_THROWS(ring.splice(empty.begin(),std::move(copied)));
+    CHECK_THROWS(ring.splice(ring.begin(),std::move(ring)));
+}
+
+TEST_CASE("Allocators")
+{
+    //pool allocator
+    PoolAllocator<int> allocator;
+    Ring<int,PoolAllocator<int>> ring1(allocator);
+    Ring<int,PoolAllocator<int>> ring2(allocator);
+    for(int x = 0; x < 2000; ++x)
+    {
+        ring1.pushLast(x);
+    }
+    CHECK(ring1.getSize() == 2000);
+    CHECK(*(ring1.begin() + 1500) == 1500);
+
+    //erased node is reused by the next insert
+    int* address = &ring1.getFirst();
+    ring1.popFirst();
+    ring1.pushLast(2000);
+    CHECK(&ring1.getLast() == address);
+
+    //rings with the same pool can exchange nodes
+    ring2.pushLast(-1);
+    ring2.splice(ring2.end(),std::move(ring1));
+    CHECK(ring2.getSize() == 2001);
+    CHECK(ring2.getFirst() == -1);
+
+    Ring<int,PoolAllocator<int>> ring3;
+    ring3.pushLast(1);
+    CHECK_THROWS(ring3.splice(ring3.end(),std::move(ring2)));
+
+    //copy shares the pool
+    Ring<int,PoolAllocator<int>> ring4(ring2);
+    CHECK(ring4.getSize() == 2001);
+    CHECK(ring4.getAllocator() == ring2.getAllocator());
+
+    //when every node is freed, pool starts from the beginning of the first slab
+    ring2.clear();
+    ring4.clear();
+    ring2.pushLast(1);
+    ring2.pushLast(2);
+    CHECK(&ring2.getFirst() == address);
+    CHECK(&ring2.getLast() != address);
+
+    //polymorphic allocator
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer,sizeof(buffer));
+    PmrRing<int> ring5(&arena);
+    createRing(ring5,10);
+    CHECK(ring5.getSize() == 10);
+    CHECK(ring5.getLast() == 10);
+    CHECK(ring5.getAllocator().resource() == &arena);
+}
+
+TEST_CASE("Unchecked ring")
+{
+    FastRing<int> ring;
+    createRing(ring,5);
+
+    int sum = 0;
+    for(auto it = ring.begin(); it != ring.end(); ++it)
+    {
+        sum += *it;
+    }
+    CHECK(sum == 15);
+
+    auto it = ring.end();
+    --it;
+    CHECK(*it == 5);
+    ring.erase(it);
+    ring.insert(ring.begin() + 1,7);
+    CHECK(ring.getSize() == 5);
+    CHECK(*(ring.begin() + 1) == 7);
+    CHECK(ring.getLast() == 4);
+
+    //steps follow the order after reverse, iterators from before it too
+    auto second = ring.begin() + 1;
+    ring.reverse();
+    std::vector<int> order;
+    for(auto x = ring.begin(); x != ring.end(); ++x)
+    {
+        order.push_back(*x);
+    }
+    CHECK(order == std::vector<int>{4,3,2,7,1});
+    CHECK(*(--second) == 2);
+
+    //default ring still validates
+    Ring<int> checked;
+    CHECK_THROWS(*checked.begin());
+    CHECK_THROWS(checked.erase(checked.end()));
+}
+
+TEST_CASE("Moving, emplacing and inserting ranges")
+{
+    Ring<std::string> ring;
+    std::string text = "abc";
+    ring.pushLast(std::move(text));
+    ring.pushFirst(std::string("first"));
+    ring.emplaceLast(3,'x');
+    ring.emplaceFirst("zero");
+    auto it = ring.emplace(ring.begin() + 2,"middle");
+    CHECK(*it == "middle");
+    //{zero,first,middle,abc,xxx}
+    CHECK(ring.getSize() == 5);
+    CHECK(ring.getFirst() == "zero");
+    CHECK(*(ring.begin() + 1) == "first");
+    CHECK(*(ring.begin() + 3) == "abc");
+    CHECK(ring.getLast() == "xxx");
+
+    //move constructor
+    Ring<std::string> moved(std::move(ring));
+    CHECK(ring.isEmpty());
+    CHECK(moved.getSize() == 5);
+    CHECK(moved.getFirst() == "zero");
+    //moved from ring can be used again
+    ring.pushLast("again");
+    CHECK(ring.getSize() == 1);
+
+    //move assignment
+    ring = std::move(moved);
+    CHECK(moved.isEmpty());
+    CHECK(ring.getSize() == 5);
+    CHECK(ring.getLast() == "xxx");
+
+    //insert range
+    Ring<int> numbers;
+    std::vector<int> values = {1,2,3};
+    numbers.insertRange(numbers.end(),values.begin(),values.end());
+    CHECK(numbers.getSize() == 3);
+    CHECK(numbers.getFirst() == 1);
+    CHECK(numbers.getLast() == 3);
+
+    std::vector<int> more = {10,11};
+    numbers.insertRange(numbers.begin() + 1,more.begin(),more.end());
+    //{1,10,11,2,3}
+    CHECK(numbers.getSize() == 5);
+    CHECK(*(numbers.begin() + 1) == 10);
+    CHECK(*(numbers.begin() + 2) == 11);
+    CHECK(*(numbers.begin() + 3) == 2);
+    CHECK(*(numbers.end() - 5) == 1);
+
+    //inserted range is indexed
+    numbers.enableIndex();
+    numbers.insertRange(numbers.end(),more.begin(),more.end());
+    CHECK(numbers.count(10) == 2);
+    CHECK(numbers.getLast() == 11);
+
+    //rings with different resources, elements are moved one by one
+    std::pmr::monotonic_buffer_resource arena1, arena2;
+    PmrRing<int> ring1(&arena1), ring2(&arena2);
+    createRing(ring1,3);
+    ring2 = std::move(ring1);
+    CHECK(ring2.getSize() == 3);
+    CHECK(ring2.getLast() == 3);
+    CHECK(ring2.getAllocator().resource() == &arena2);
+
+    //split result is moved
+    auto result = split(numbers,0,7,true,1,true,1,true);
+    CHECK(result.first.getSize() == 4);
+    CHECK(result.second.getSize() == 3);
+}
+
+TEST_CASE("Bounded ring")
+{
+    Ring<int,PoolAllocator<int>> ring;
+    CHECK_THROWS(ring.setCapacity(-1));
+    ring.setCapacity(3);
+    CHECK(ring.getCapacity() == 3);
+
+    //all nodes are reserved, pushing and popping reuses them
+    ring.pushLast(1);
+    int* address = &ring.getFirst();
+    ring.pushLast(2);
+    ring.pushLast(3);
+    CHECK(ring.isFull());
+
+    //the oldest element is overwritten
+    ring.pushLast(4);
+    CHECK(ring.getSize() == 3);
+    CHECK(ring.getFirst() == 2);
+    CHECK(ring.getLast() == 4);
+    CHECK(&ring.getLast() == address);
+    ring.emplaceLast(5);
+    //iteration from the oldest to the newest
+    for(int x = 0; x < 3; ++x)
+    {
+        CHECK(*(ring.begin() + x) == x + 3);
+    }
+
+    //other inserts can't exceed capacity
+    CHECK_THROWS_AS(ring.pushFirst(0),std::length_error);
+    CHECK_THROWS_AS(ring.insert(ring.begin() + 1,0),std::length_error);
+    std::vector<int> values = {1,2};
+    CHECK_THROWS_AS(ring.insertRange(ring.end(),values.begin(),values.end()),std::length_error);
+    CHECK(ring.getSize() == 3);
+    CHECK_THROWS(ring.setCapacity(2));
+
+    //index follows overwritten elements
+    ring.enableIndex();
+    ring.pushLast(6);
+    CHECK(ring.isInside(3) == false);
+    CHECK(ring.isInside(6));
+
+    ring.popFirst();
+    ring.pushLast(7);
+    CHECK(ring.getSize() == 3);
+    CHECK(ring.getFirst() == 5);
+
+    //copy is bounded too
+    Ring<int,PoolAllocator<int>> copied(ring);
+    CHECK(copied.getCapacity() == 3);
+    copied.pushLast(8);
+    CHECK(copied.getFirst() == 6);
+
+    //assigned ring takes capacity of the other one
+    Ring<int,PoolAllocator<int>> big;
+    createRing(big,5);
+    copied = big;
+    CHECK(copied.getCapacity() == 0);
+    CHECK(copied.getSize() == 5);
+
+    //unbounded again
+    ring.setCapacity(0);
+    ring.pushLast(8);
+    CHECK(ring.getSize() == 4);
+
+    //element, which can't be created, doesn't overwrite anything
+    Ring<std::string> words;
+    words.setCapacity(2);
+    words.enableIndex();
+    words.pushLast("a");
+    words.pushLast("b");
+    CHECK_THROWS_AS(words.emplaceLast(std::string().max_size() + 1,'x'),std::length_error);
+    CHECK(words.getFirst() == "a");
+    CHECK(words.isInside("a"));
+    CHECK(words.count("a") == 1);
+    words.pushLast("c");
+    CHECK(words.isInside("a") == false);
+    CHECK(words.count("c") == 1);
+}
+
+TEST_CASE("Aggregated ring")
+{
+    AggregatedRing<int,RingSum<int>> sum;
+    AggregatedRing<int,RingMin<int>> min;
+    AggregatedRing<int,RingMax<int>> max;
+    CHECK(sum.aggregate() == 0);
+
+    for(int x = 1; x <= 10; ++x)
+    {
+        sum.pushLast(x);
+        min.pushLast(x);
+        max.pushFirst(x);
+    }
+    CHECK(sum.aggregate() == 55);
+    CHECK(min.aggregate() == 1);
+    CHECK(max.aggregate() == 10);
+
+    //queue operations
+    sum.popFirst();
+    min.popFirst();
+    max.popFirst();
+    CHECK(sum.aggregate() == 54);
+    CHECK(min.aggregate() == 2);
+    CHECK(max.aggregate() == 9);
+
+    min.pushFirst(-5);
+    CHECK(min.aggregate() == -5);
+    min.popFirst();
+    min.popFirst();
+    CHECK(min.aggregate() == 3);
+
+    //operations in the middle
+    min.insert(min.begin() + 3,0);
+    CHECK(min.aggregate() == 0);
+    min.erase(min.begin() + 3);
+    CHECK(min.aggregate() == 3);
+    max.popLast();
+    max.erase(max.begin());
+    CHECK(max.aggregate() == 8);
+    sum.popLast();
+    CHECK(sum.aggregate() == 44);
+
+    //sliding window
+    AggregatedRing<int,RingMax<int>> window;
+    AggregatedRing<int,RingSum<int>> windowSum;
+    window.setCapacity(3);
+    windowSum.setCapacity(3);
+    int values[] = {5,1,2,7,3,1,1,1};
+    int maxima[] = {5,5,5,7,7,7,3,1};
+    int sums[] = {5,6,8,10,12,11,5,3};
+    for(int x = 0; x < 8; ++x)
+    {
+        window.pushLast(values[x]);
+        windowSum.pushLast(values[x]);
+        CHECK(window.aggregate() == maxima[x]);
+        CHECK(windowSum.aggregate() == sums[x]);
+    }
+
+    window.clear();
+    CHECK(window.isEmpty());
+    CHECK(window.aggregate() == std::numeric_limits<int>::lowest());
+
+    //erasing by iterator of other ring changes neither ring nor aggregate
+    AggregatedRing<int,RingSum<int>> small;
+    AggregatedRing<int,RingSum<int>> foreign;
+    small.pushLast(1);
+    small.pushLast(2);
+    foreign.pushLast(100);
+    CHECK_THROWS_AS(small.erase(foreign.begin()),std::invalid_argument);
+    CHECK(small.getSize() == 2);
+    CHECK(small.aggregate() == 3);
+    small.pushLast(4);
+    CHECK(small.aggregate() == 7);
+
+    AggregatedRing<int,RingMin<int>> smallMin;
+    AggregatedRing<int,RingMin<int>> foreignMin;
+    smallMin.pushLast(5);
+    smallMin.pushLast(6);
+    foreignMin.pushLast(-100);
+    CHECK(smallMin.aggregate() == 5);
+    CHECK_THROWS_AS(smallMin.erase(foreignMin.begin()),std::invalid_argument);
+    CHECK(smallMin.aggregate() == 5);
+    smallMin.popFirst();
+    CHECK(smallMin.aggregate() == 6);
+}
+
+TEST_CASE("K-way split")
+{
+    Ring<int> ring1;
+    createRing(ring1,10);
+
+    CHECK_THROWS(split(ring1,-1,5,true,{{1,true}}));
+    CHECK_THROWS(split(ring1,0,5,true,{{-1,true}}));
+    CHECK_THROWS(split(ring1,0,5,true,{{0,true},{0,false}}));
+
+    //the same result as split into two rings
+    auto pair = split(ring1, 2, 16, true, 3, true, 2, false);
+    auto rings = split(ring1, 2, 16, true, {{3,true},{2,false}});
+    CHECK(rings.size() == 2);
+    CHECK(rings[0].getSize() == pair.first.getSize());
+    CHECK(rings[1].getSize() == pair.second.getSize());
+    for(int x = 0; x < pair.first.getSize(); ++x)
+    {
+        CHECK(*(rings[0].begin() + x) == *(pair.first.begin() + x));
+    }
+    for(int x = 0; x < pair.second.getSize(); ++x)
+    {
+        CHECK(*(rings[1].begin() + x) == *(pair.second.begin() + x));
+    }
+
+    //backward through the source
+    pair = split(ring1, 3, 13, false, 1, false, 3, true);
+    rings = split(ring1, 3, 13, false, {{1,false},{3,true}});
+    for(int x = 0; x < pair.first.getSize(); ++x)
+    {
+        CHECK(*(rings[0].begin() + x) == *(pair.first.begin() + x));
+    }
+    for(int x = 0; x < pair.second.getSize(); ++x)
+    {
+        CHECK(*(rings[1].begin() + x) == *(pair.second.begin() + x));
+    }
+
+    //three rings
+    rings = split(ring1, 0, 10, true, {{1,true},{2,true},{0,true},{1,false}});
+    //{1,5,9} {2,3,6,7,10} {} {4,8}
+    CHECK(rings.size() == 4);
+    CHECK(rings[0].getSize() == 3);
+    CHECK(rings[1].getSize() == 5);
+    CHECK(rings[2].isEmpty());
+    CHECK(rings[3].getSize() == 2);
+    CHECK(*(rings[0].begin() + 2) == 9);
+    CHECK(rings[1].getLast() == 10);
+    CHECK(rings[3].getFirst() == 4);
+
+    //big ring is split in parallel
+    Ring<int> big;
+    createRing(big,100000);
+    rings = split(big, 0, 100000, true, {{1,true},{1,true},{2,false}});
+    CHECK(rings[0].getSize() == 25000);
+    CHECK(rings[1].getSize() == 25000);
+    CHECK(rings[2].getSize() == 50000);
+    CHECK(rings[0].getLast() == 99997);
+    CHECK(rings[2].getFirst() == 3);
+    CHECK(*(rings[2].begin() + 1) == 100000);
+}
+
+TEST_CASE("Split view")
+{
+    Ring<int> ring1;
+    createRing(ring1,10);
 
+    CHECK_THROWS(SplitView<int,std::allocator<int>,CheckedRing>(ring1,-1,5,true,1,true,1,true));
+    CHECK_THROWS(SplitView<int,std::allocator<int>,CheckedRing>(ring1,0,5,true,0,true,0,true));
 
+    //every combination of directions gives the same elements as split
+    for(int direction = 0; direction < 2; ++direction)
+    {
+        for(int direction1 = 0; direction1 < 2; ++direction1)
+        {
+            for(int direction2 = 0; direction2 < 2; ++direction2)
+            {
+                auto result = split(ring1,2,16,direction,3,direction1,2,direction2);
+                SplitView view(ring1,2,16,direction,3,direction1,2,direction2);
+                auto first = view.first();
+                auto second = view.second();
+                CHECK(first.getSize() == result.first.getSize());
+                CHECK(second.getSize() == result.second.getSize());
 
+                auto it = result.first.begin();
+                for(const int& x : first)
+                {
+                    CHECK(x == *it);
+                    ++it;
+                }
+                it = result.second.begin();
+                for(auto x = second.begin(); x != second.end(); ++x)
+                {
+                    CHECK(*x == *it);
+                    ++it;
+                }
+            }
+        }
+    }
 
+    //one half is empty
+    SplitView view(ring1,0,5,true,0,true,2,false);
+    CHECK(view.first().isEmpty());
+    CHECK(view.first().begin() == view.first().end());
+    CHECK(view.second().getSize() == 5);
+    CHECK(*view.second().begin() == 1);
 
+    //empty source
+    Ring<int> empty;
+    SplitView emptyView(empty,0,5,true,1,true,1,true);
+    CHECK(emptyView.first().getSize() == 0);
+    CHECK(emptyView.second().getSize() == 0);
+}
 
+TEST_CASE("Eliminator")
+{
+    Ring<int> ring1;
+    CHECK_THROWS(Eliminator(ring1,0));
+    Eliminator<int,std::allocator<int>,CheckedRing> empty(ring1,3);
+    CHECK_THROWS(empty.eliminate());
 
+    //Josephus problem for 7 elements and k = 3
+    createRing(ring1,7);
+    Eliminator eliminator(ring1,3);
+    CHECK(eliminator.peek() == 3);
+    CHECK(eliminator.eliminate() == 3);
+    CHECK(ring1.getSize() == 6);
+    std::vector<int> removed = eliminator.eliminateUntil(1);
+    CHECK(removed == std::vector<int>({6,2,7,5,1}));
+    CHECK(ring1.getSize() == 1);
+    CHECK(ring1.getFirst() == 4);
+    CHECK(eliminator.getRemaining() == 1);
+    CHECK(eliminator.eliminate() == 4);
+    CHECK(ring1.isEmpty());
 
+    //counting backward from given element, step bigger than size
+    ring1.clear();
+    createRing(ring1,5);
+    Eliminator backward(ring1,ring1.begin() + 2,7,false);
+    removed = backward.eliminateUntil([](const Ring<int>& r){return r.getSize() == 2;});
+    CHECK(removed == std::vector<int>({2,4,3}));
+    CHECK(ring1.getFirst() == 1);
+    CHECK(ring1.getLast() == 5);
 
+    //ring changed outside of the eliminator
+    ring1.pushLast(10);
+    CHECK_THROWS(backward.eliminate());
 
+    //the same order as simulation on vector, for reversed and indexed ring
+    Ring<int> ring2;
+    createRing(ring2,1000);
+    ring2.reverse();
+    ring2.enableIndex();
+    std::vector<int> people;
+    for(int x : ring2)
+    {
+        people.push_back(x);
+    }
+    Eliminator fast(ring2,ring2.begin() + 10,17);
+    size_t position = 10;
+    while(!people.empty())
+    {
+        position = (position + 16) % people.size();
+        CHECK(fast.eliminate() == people[position]);
+        people.erase(people.begin() + position);
+    }
+    CHECK(ring2.isEmpty());
+    CHECK(!ring2.isInside(5));
+}
+
+TEST_CASE("Saving and loading")
+{
+    Ring<int> ring1;
+    Ring<int> ring2;
+    createRing(ring1,10000);
+    ring1.reverse();
 
+    //elements are saved in the order visible to the user
+    std::stringstream stream;
+    ring1.save(stream);
+    CHECK(stream.str().size() == 32 + 10000 * sizeof(int));
+    ring2.pushLast(5);
+    ring2.load(stream);
+    CHECK(ring2.getSize() == 10000);
+    CHECK(ring2.getFirst() == 10000);
+    CHECK(ring2.getLast() == 1);
+
+    //empty ring
+    Ring<int> empty;
+    std::stringstream emptyStream;
+    empty.save(emptyStream);
+    ring2.load(emptyStream);
+    CHECK(ring2.isEmpty());
+
+    //strings are saved element by element
+    Ring<std::string> words;
+    Ring<std::string> loaded;
+    words.pushLast("first");
+    words.pushLast("");
+    words.pushLast("third word");
+    std::stringstream wordStream;
+    words.save(wordStream);
+    loaded.enableIndex();
+    loaded.load(wordStream);
+    CHECK(loaded.getSize() == 3);
+    CHECK(loaded.getFirst() == "first");
+    CHECK(*(loaded.begin() + 1) == "");
+    CHECK(loaded.getLast() == "third word");
+    CHECK(loaded.isInside("third word"));
+
+    //wrong or broken data
+    std::stringstream wrong("not a ring at all, just some text");
+    CHECK_THROWS(ring2.load(wrong));
+    wordStream.clear();
+    wordStream.seekg(0);
+    CHECK_THROWS(ring2.load(wordStream));
+    std::stringstream broken(stream.str().substr(0,1000));
+    CHECK_THROWS(ring2.load(broken));
+
+    //bounded ring has to take all elements
+    Ring<int> bounded;
+    bounded.setCapacity(10);
+    stream.clear();
+    stream.seekg(0);
+    CHECK_THROWS(bounded.load(stream));
+
+    SECTION("Raw elements without default constructor")
+    {
+        struct Point
+        {
+            int x;
+            int y;
+            Point(int first, int second) : x(first), y(second){};
+        };
+        Ring<Point> points;
+        for(int i = 0; i < 5000; ++i)
+        {
+            points.pushLast(Point(i,-i));
+        }
+        std::stringstream pointStream;
+        points.save(pointStream);
+        Ring<Point> loadedPoints;
+        loadedPoints.load(pointStream);
+        CHECK(loadedPoints.getSize() == 5000);
+        CHECK(loadedPoints.getFirst().x == 0);
+        CHECK(loadedPoints.getLast().x == 4999);
+        CHECK(loadedPoints.getLast().y == -4999);
+    }
+
+    SECTION("Failed loading doesn't change the ring")
+    {
+        Ring<int> small;
+        small.setCapacity(3);
+        small.enableIndex();
+        small.pushLast(7);
+        std::stringstream four;
+        Ring<int> source;
+        createRing(source,4);
+        source.save(four);
+        CHECK_THROWS_AS(small.load(four),std::length_error);
+        CHECK(small.getSize() == 1);
+        CHECK(small.getFirst() == 7);
+
+        //stream ends in the middle of elements
+        std::stringstream three;
+        source.popLast();
+        source.save(three);
+        std::stringstream truncated(three.str().substr(0,32 + 2 * sizeof(int)));
+        CHECK_THROWS_AS(small.load(truncated),std::runtime_error);
+        CHECK(small.getSize() == 1);
+        CHECK(small.getFirst() == 7);
+        CHECK(small.isInside(7));
+
+        //loaded ring keeps capacity and index
+        small.load(three);
+        CHECK(small.getSize() == 3);
+        CHECK(small.getCapacity() == 3);
+        CHECK(small.isInside(3));
+        CHECK_FALSE(small.isInside(7));
+        CHECK(small.isFull());
+
+        Ring<std::string> text;
+        text.pushLast("kept");
+        std::stringstream brokenWords(wordStream.str().substr(0,wordStream.str().size() - 3));
+        CHECK_THROWS(text.load(brokenWords));
+        CHECK(text.getSize() == 1);
+        CHECK(text.getFirst() == "kept");
+    }
+}
+
+TEST_CASE("Mapped ring")
+{
+    const char* path = "test_ring_mapped.bin";
+    Ring<int> ring1;
+    createRing(ring1,5);
+    {
+        std::ofstream file(path,std::ios::binary);
+        ring1.save(file);
+    }
+
+    {
+        MappedRing<int> mapped(path);
+        CHECK(mapped.getSize() == 5);
+        CHECK(mapped.getFirst() == 1);
+        CHECK(mapped.getLast() == 5);
+
+        int x = 1;
+        for(const int& element : mapped)
+        {
+            CHECK(element == x);
+            ++x;
+        }
+
+        //the same rules as for iterators of ring
+        auto it = mapped.end();
+        CHECK_THROWS(*it);
+        CHECK_THROWS(++it);
+        --it;
+        CHECK(*it == 5);
+        CHECK(*(mapped.begin() + 2) == 3);
+        CHECK(*(mapped.end() - 5) == 1);
+        CHECK_THROWS(mapped.begin() - 1);
+        CHECK_THROWS(mapped.begin() + 6);
+
+        //moving around the ring
+        moveRingIterator(it,mapped,true);
+        CHECK(it == mapped.begin());
+        moveRingIterator(it,mapped,false);
+        CHECK(*it == 5);
+
+        CHECK_THROWS(MappedRing<short>(path));
+    }
+
+    //descriptor is closed right after mapping, so the next open gets the same one as before
+    int before = open(path,O_RDONLY);
+    close(before);
+    {
+        MappedRing<int> mapped(path);
+        int after = open(path,O_RDONLY);
+        CHECK(after == before);
+        close(after);
+        CHECK(mapped.getLast() == 5);
+    }
+
+    Ring<int> empty;
+    {
+        std::ofstream file(path,std::ios::binary);
+        empty.save(file);
+    }
+    {
+        MappedRing<int> mapped(path);
+        CHECK(mapped.isEmpty());
+        CHECK(mapped.begin() == mapped.end());
+        CHECK_THROWS(mapped.getFirst());
+    }
+
+    std::remove(path);
+    CHECK_THROWS(MappedRing<int>(path));
+}
+
+TEST_CASE("Assigning configuration of rings")
+{
+    //configuration of assigned ring is always taken from the other ring
+    Ring<int> bounded;
+    bounded.setCapacity(4);
+    bounded.enableIndex();
+    createRing(bounded,3);
+
+    SECTION("Copy assignment")
+    {
+        Ring<int> target;
+        createRing(target,2);
+        target = bounded;
+        CHECK(target.getCapacity() == 4);
+        CHECK(target.isIndexed());
+        CHECK(target.count(2) == 1);
+
+        Ring<int> plain;
+        createRing(plain,6);
+        target = plain;
+        CHECK(target.getCapacity() == 0);
+        CHECK_FALSE(target.isIndexed());
+        CHECK(target.getSize() == 6);
+    }
+
+    SECTION("Move assignment with equal allocators")
+    {
+        Ring<int> target;
+        target.setCapacity(10);
+        target = std::move(bounded);
+        CHECK(target.getCapacity() == 4);
+        CHECK(target.isIndexed());
+        CHECK(target.count(3) == 1);
+
+        Ring<int> plain;
+        createRing(plain,6);
+        target = std::move(plain);
+        CHECK(target.getCapacity() == 0);
+        CHECK_FALSE(target.isIndexed());
+        CHECK(target.getSize() == 6);
+    }
+
+    SECTION("Move assignment with different allocators")
+    {
+        //polymorphic allocators with different resources are not equal and don't propagate
+        std::pmr::unsynchronized_pool_resource first;
+        std::pmr::unsynchronized_pool_resource second;
+        PmrRing<int> source(&first);
+        source.setCapacity(4);
+        source.enableIndex();
+        createRing(source,3);
+
+        PmrRing<int> target(&second);
+        target.setCapacity(10);
+        target = std::move(source);
+        CHECK(target.getAllocator().resource() == &second);
+        CHECK(target.getCapacity() == 4);
+        CHECK(target.isIndexed());
+        CHECK(target.count(3) == 1);
+        CHECK(target.count(4) == 0);
+        CHECK(source.getSize() == 0);
+
+        PmrRing<int> plain(&first);
+        createRing(plain,6);
+        target = std::move(plain);
+        CHECK(target.getCapacity() == 0);
+        CHECK_FALSE(target.isIndexed());
+        CHECK(target.getSize() == 6);
+        CHECK(target.getLast() == 6);
+    }
+}
+
+TEST_CASE("Splicing into bounded ring")
+{
+    long long& allocated = countedAllocations;
+    {
+        Ring<int,CountingAllocator<int>> bounded;
+        bounded.setCapacity(10);
+        createRing(bounded,2);
+        long long reserved = allocated;
+
+        Ring<int,CountingAllocator<int>> other;
+        createRing(other,5);
+        CHECK_THROWS_AS(bounded.splice(bounded.end(),std::move(bounded)),std::invalid_argument);
+        bounded.splice(bounded.end(),std::move(other));
+        CHECK(bounded.getSize() == 7);
+
+        //nodes taken from other ring replaced reserved ones
+        CHECK(allocated == reserved);
+        while(!bounded.isEmpty())
+        {
+            bounded.popFirst();
+        }
+        CHECK(allocated == reserved);
+        createRing(bounded,10);
+        CHECK(allocated == reserved);
+        CHECK(bounded.isFull());
+    }
+    CHECK(allocated == 0);
+}